@@ -0,0 +1,42 @@
+TARGET = aggregationbenchmark
+
+TEMPLATE = app
+
+QT += concurrent network testlib
+QT -= gui
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+win32: LIBS += -lPsapi
+
+INCLUDEPATH += ../common \
+               ../../src \
+               ../../src/3rdparty/zlib
+
+SOURCES = aggregationbenchmark.cpp \
+          ../common/benchmarkhelpers.cpp \
+          ../../src/aggregation.cpp \
+          ../../src/inflater.cpp \
+          ../../src/levelupprojection.cpp \
+          ../../src/metrics.cpp \
+          ../../src/wanikani.cpp \
+          ../../src/workloadforecast.cpp \
+          ../../src/3rdparty/zlib/adler32.c \
+          ../../src/3rdparty/zlib/crc32.c \
+          ../../src/3rdparty/zlib/deflate.c \
+          ../../src/3rdparty/zlib/inffast.c \
+          ../../src/3rdparty/zlib/inflate.c \
+          ../../src/3rdparty/zlib/inftrees.c \
+          ../../src/3rdparty/zlib/trees.c \
+          ../../src/3rdparty/zlib/zutil.c
+
+HEADERS = ../common/benchmarkhelpers.h \
+          ../../src/aggregation.h \
+          ../../src/inflater.h \
+          ../../src/levelupprojection.h \
+          ../../src/metrics.h \
+          ../../src/wanikani.h \
+          ../../src/workloadforecast.h
@@ -0,0 +1,369 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Aggregation benchmark
+//==============================================================================
+
+#include "aggregation.h"
+#include "benchmarkhelpers.h"
+#include "wanikani.h"
+
+//==============================================================================
+
+#include <QDateTime>
+#include <QtTest>
+
+//==============================================================================
+
+static const int UserLevel = 30;
+static const int MaximumLevel = 60;
+
+//==============================================================================
+
+class AggregationBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum Version {
+        OldLoopsVersion,
+        SinglePassVersion
+    };
+
+    struct Results
+    {
+        Reviews currentRadicalsReviews;
+        Reviews allRadicalsReviews;
+        Reviews currentKanjiReviews;
+        Reviews allKanjiReviews;
+        Reviews currentVocabularyReviews;
+        Reviews allVocabularyReviews;
+        QMap<QChar, QString> currentKanjiState;
+        QMap<QChar, QString> allKanjiState;
+        qint64 levelStartTime = 0;
+    };
+
+    std::shared_ptr<const Snapshot> mSnapshot;
+
+    static QByteArray v1Response(const QString &pItemType, int pNbOfItemsPerLevel);
+    static std::shared_ptr<const Snapshot> v1Snapshot(const QByteArray &pRadicalsResponse,
+                                                      const QByteArray &pKanjiResponse,
+                                                      const QByteArray &pVocabularyResponse);
+
+    template<typename T>
+    static T copied(const T &pValue);
+
+    static void oldLoops(const Snapshot &pSnapshot, Results &pResults,
+                         LevelUpProjection &pLevelUpProjection,
+                         WorkloadForecast &pWorkloadForecast);
+
+private slots:
+    void initTestCase();
+
+    void sameResults();
+
+    void aggregation_data();
+    void aggregation();
+};
+
+//==============================================================================
+
+QByteArray AggregationBenchmark::v1Response(const QString &pItemType,
+                                            int pNbOfItemsPerLevel)
+{
+    // Generate a v1 response for the given type of items, with the given
+    // number of items per level, which looks like the one of a user of level
+    // UserLevel, i.e. with items that are passed, in progress or locked
+    // Note: our characters are all different, so that our Kanji state has as
+    //       many entries as we have Kanji...
+
+    static const QStringList SrsNames = QStringList() << "apprentice" << "apprentice" << "apprentice" << "apprentice" << "apprentice"
+                                                      << "guru" << "guru" << "master" << "enlighten" << "burned";
+    static const QString ItemJson = "{\"character\":\"%1\",\"meaning\":\"%2 %3\",\"kana\":\"kana %3\",\"level\":%4,\"user_specific\":%5}";
+    static const QString UserSpecificJson = "{\"srs\":\"%1\",\"srs_numeric\":%2,\"unlocked_date\":%3,\"available_date\":%4,"
+                                            "\"burned\":%5,\"burned_date\":0,\"meaning_correct\":%6,\"meaning_incorrect\":%7,"
+                                            "\"meaning_max_streak\":3,\"meaning_current_streak\":1,\"reading_correct\":%6,"
+                                            "\"reading_incorrect\":%7,\"reading_max_streak\":3,\"reading_current_streak\":1,"
+                                            "\"meaning_note\":null,\"user_synonyms\":null}";
+
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    QStringList items;
+
+    for (int level = 1, i = 0; level <= MaximumLevel; ++level) {
+        for (int j = 0; j < pNbOfItemsPerLevel; ++j, ++i) {
+            QString userSpecific = "null";
+
+            if (level <= UserLevel) {
+                int srsNumeric = (level < UserLevel)?5+i%5:i%5;
+                bool burned = srsNumeric == 9;
+
+                userSpecific = UserSpecificJson.arg(SrsNames[srsNumeric])
+                                               .arg(srsNumeric)
+                                               .arg(now-86400*(UserLevel-level+1)-3600*j)
+                                               .arg(burned?0:now+3600*(i%(24*14))-7200)
+                                               .arg(burned?"true":"false")
+                                               .arg(10+i%20)
+                                               .arg(i%5);
+            }
+
+            items << ItemJson.arg(QChar(0x4e00+i))
+                             .arg(pItemType)
+                             .arg(i)
+                             .arg(level)
+                             .arg(userSpecific);
+        }
+    }
+
+    return QString("{\"user_information\":{\"username\":\"benchmark\",\"level\":%1},\"requested_information\":[%2]}").arg(UserLevel)
+                                                                                                                 .arg(items.join(","))
+                                                                                                                 .toUtf8();
+}
+
+//==============================================================================
+
+std::shared_ptr<const Snapshot> AggregationBenchmark::v1Snapshot(const QByteArray &pRadicalsResponse,
+                                                                const QByteArray &pKanjiResponse,
+                                                                const QByteArray &pVocabularyResponse)
+{
+    // Return a snapshot for a user of level UserLevel, made of the given v1
+    // radicals, Kanji and vocabulary responses, so that we can benchmark what
+    // we do with a snapshot without having to retrieve it
+    // Note: we are a friend of both WaniKani and Snapshot, so that we can do
+    //       this without WaniKani having to expose a way to build a snapshot.
+    //       Also, nothing gets derived from our items here...
+
+    Snapshot *snapshot = new Snapshot();
+
+    snapshot->mUser.mLevel = UserLevel;
+    snapshot->mRadicals = WaniKani::parseRadicals(pRadicalsResponse).items;
+    snapshot->mKanjis = WaniKani::parseKanjis(pKanjiResponse).items;
+    snapshot->mVocabularies = WaniKani::parseVocabularies(pVocabularyResponse).items;
+    snapshot->mItemColumns = WaniKani::itemColumns(snapshot->mRadicals,
+                                                   snapshot->mKanjis,
+                                                   snapshot->mVocabularies);
+
+    return std::shared_ptr<const Snapshot>(snapshot);
+}
+
+//==============================================================================
+
+template<typename T>
+T AggregationBenchmark::copied(const T &pValue)
+{
+    // Return a copy of the given value, like userSpecific() used to do
+
+    return pValue;
+}
+
+//==============================================================================
+
+void AggregationBenchmark::oldLoops(const Snapshot &pSnapshot,
+                                    Results &pResults,
+                                    LevelUpProjection &pLevelUpProjection,
+                                    WorkloadForecast &pWorkloadForecast)
+{
+    // Aggregate the given snapshot the way we used to, i.e. retrieving our
+    // user level for every item, copying the user specific information of an
+    // item every time we need it, and going through our items once for our
+    // reviews and Kanji state, and once more for each of our level up
+    // projection and workload forecast
+
+    pResults = Results();
+
+    for (const auto &radical : pSnapshot.radicals()) {
+        if (radical.level() == pSnapshot.user().level()) {
+            if (   !pResults.levelStartTime
+                ||  (   copied(radical.userSpecific()).unlockedDate()
+                     && (copied(radical.userSpecific()).unlockedDate() < pResults.levelStartTime))) {
+                pResults.levelStartTime = copied(radical.userSpecific()).unlockedDate();
+            }
+        }
+
+        if (copied(radical.userSpecific()).availableDate()) {
+            qint64 time = copied(radical.userSpecific()).availableDate();
+
+            if (radical.level() == pSnapshot.user().level()) {
+                ++pResults.currentRadicalsReviews[time];
+            }
+
+            ++pResults.allRadicalsReviews[time];
+        }
+    }
+
+    for (const auto &kanji : pSnapshot.kanjis()) {
+        if (kanji.level() <= pSnapshot.user().level())
+            pResults.currentKanjiState.insert(kanji.character(), copied(kanji.userSpecific()).srs());
+
+        pResults.allKanjiState.insert(kanji.character(), copied(kanji.userSpecific()).srs());
+
+        if (copied(kanji.userSpecific()).availableDate()) {
+            qint64 time = copied(kanji.userSpecific()).availableDate();
+
+            if (kanji.level() == pSnapshot.user().level()) {
+                ++pResults.currentKanjiReviews[time];
+            }
+
+            ++pResults.allKanjiReviews[time];
+        }
+    }
+
+    for (const auto &vocabulary : pSnapshot.vocabularies()) {
+        if (copied(vocabulary.userSpecific()).availableDate()) {
+            qint64 time = copied(vocabulary.userSpecific()).availableDate();
+
+            if (vocabulary.level() == pSnapshot.user().level()) {
+                ++pResults.currentVocabularyReviews[time];
+            }
+
+            ++pResults.allVocabularyReviews[time];
+        }
+    }
+
+    pLevelUpProjection.reset(pSnapshot.user().level());
+
+    for (const auto &radical : pSnapshot.radicals()) {
+        pLevelUpProjection.add(ItemColumns::RadicalType, radical.level(),
+                               copied(radical.userSpecific()).srsNumeric(),
+                               copied(radical.userSpecific()).unlockedDate(),
+                               copied(radical.userSpecific()).availableDate(),
+                               copied(radical.userSpecific()).meaningCorrect(),
+                               copied(radical.userSpecific()).meaningIncorrect());
+    }
+
+    for (const auto &kanji : pSnapshot.kanjis()) {
+        pLevelUpProjection.add(ItemColumns::KanjiType, kanji.level(),
+                               copied(kanji.userSpecific()).srsNumeric(),
+                               copied(kanji.userSpecific()).unlockedDate(),
+                               copied(kanji.userSpecific()).availableDate(),
+                               copied(kanji.userSpecific()).meaningCorrect()+copied(kanji.userSpecific()).readingCorrect(),
+                               copied(kanji.userSpecific()).meaningIncorrect()+copied(kanji.userSpecific()).readingIncorrect());
+    }
+
+    pWorkloadForecast.reset();
+
+    for (const auto &radical : pSnapshot.radicals()) {
+        pWorkloadForecast.add(ItemColumns::RadicalType, radical.level(),
+                              copied(radical.userSpecific()).srsNumeric(),
+                              copied(radical.userSpecific()).unlockedDate(),
+                              copied(radical.userSpecific()).availableDate());
+    }
+
+    for (const auto &kanji : pSnapshot.kanjis()) {
+        pWorkloadForecast.add(ItemColumns::KanjiType, kanji.level(),
+                              copied(kanji.userSpecific()).srsNumeric(),
+                              copied(kanji.userSpecific()).unlockedDate(),
+                              copied(kanji.userSpecific()).availableDate());
+    }
+
+    for (const auto &vocabulary : pSnapshot.vocabularies()) {
+        pWorkloadForecast.add(ItemColumns::VocabularyType, vocabulary.level(),
+                              copied(vocabulary.userSpecific()).srsNumeric(),
+                              copied(vocabulary.userSpecific()).unlockedDate(),
+                              copied(vocabulary.userSpecific()).availableDate());
+    }
+}
+
+//==============================================================================
+
+void AggregationBenchmark::initTestCase()
+{
+    // Create a snapshot with roughly as many radicals, Kanji and vocabulary as
+    // WaniKani has
+
+    mSnapshot = v1Snapshot(BenchmarkHelpers::gzipped(v1Response("radical", 8)),
+                           BenchmarkHelpers::gzipped(v1Response("kanji", 35)),
+                           BenchmarkHelpers::gzipped(v1Response("vocabulary", 110)));
+
+    QCOMPARE(mSnapshot->radicals().count(), 8*MaximumLevel);
+    QCOMPARE(mSnapshot->kanjis().count(), 35*MaximumLevel);
+    QCOMPARE(mSnapshot->vocabularies().count(), 110*MaximumLevel);
+}
+
+//==============================================================================
+
+void AggregationBenchmark::sameResults()
+{
+    // Make sure that our old loops and our single pass give the same results
+
+    Results results;
+    LevelUpProjection levelUpProjection;
+    WorkloadForecast workloadForecast;
+    Aggregation aggregation;
+
+    oldLoops(*mSnapshot, results, levelUpProjection, workloadForecast);
+    aggregation.aggregate(*mSnapshot, levelUpProjection, workloadForecast);
+
+    QCOMPARE(aggregation.currentRadicalsReviews(), results.currentRadicalsReviews);
+    QCOMPARE(aggregation.allRadicalsReviews(), results.allRadicalsReviews);
+    QCOMPARE(aggregation.currentKanjiReviews(), results.currentKanjiReviews);
+    QCOMPARE(aggregation.allKanjiReviews(), results.allKanjiReviews);
+    QCOMPARE(aggregation.currentVocabularyReviews(), results.currentVocabularyReviews);
+    QCOMPARE(aggregation.allVocabularyReviews(), results.allVocabularyReviews);
+    QCOMPARE(aggregation.currentKanjiState(), results.currentKanjiState);
+    QCOMPARE(aggregation.allKanjiState(), results.allKanjiState);
+    QCOMPARE(aggregation.levelStartTime(), results.levelStartTime);
+}
+
+//==============================================================================
+
+void AggregationBenchmark::aggregation_data()
+{
+    // Our aggregation data
+
+    QTest::addColumn<int>("version");
+
+    QTest::newRow("old loops") << int(OldLoopsVersion);
+    QTest::newRow("single pass") << int(SinglePassVersion);
+}
+
+//==============================================================================
+
+void AggregationBenchmark::aggregation()
+{
+    // Determine how long it takes the given version to aggregate our snapshot
+
+    QFETCH(int, version);
+
+    Results results;
+    LevelUpProjection levelUpProjection;
+    WorkloadForecast workloadForecast;
+    Aggregation aggregation;
+
+    if (version == OldLoopsVersion) {
+        QBENCHMARK {
+            oldLoops(*mSnapshot, results, levelUpProjection, workloadForecast);
+        }
+    } else {
+        QBENCHMARK {
+            aggregation.aggregate(*mSnapshot, levelUpProjection, workloadForecast);
+        }
+    }
+}
+
+//==============================================================================
+
+QTEST_APPLESS_MAIN(AggregationBenchmark)
+
+//==============================================================================
+
+#include "aggregationbenchmark.moc"
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,63 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Benchmark helpers
+//==============================================================================
+
+#include "benchmarkhelpers.h"
+
+//==============================================================================
+
+#include <cstring>
+
+//==============================================================================
+
+#include "zlib.h"
+
+//==============================================================================
+
+QByteArray BenchmarkHelpers::gzipped(const QByteArray &pData)
+{
+    // Compress the given data as a gzip member, like a server would
+
+    z_stream stream;
+
+    memset(&stream, 0, sizeof(z_stream));
+
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS+16, 8, Z_DEFAULT_STRATEGY);
+
+    QByteArray res = QByteArray(int(deflateBound(&stream, uLong(pData.size()))), Qt::Uninitialized);
+
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(pData.constData()));
+    stream.avail_in = uInt(pData.size());
+    stream.next_out = reinterpret_cast<Bytef *>(res.data());
+    stream.avail_out = uInt(res.size());
+
+    deflate(&stream, Z_FINISH);
+
+    res.resize(int(stream.total_out));
+
+    deflateEnd(&stream);
+
+    return res;
+}
+
+//==============================================================================
+// End of file
+//==============================================================================
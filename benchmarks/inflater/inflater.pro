@@ -0,0 +1,40 @@
+TARGET = inflaterbenchmark
+
+TEMPLATE = app
+
+QT += testlib
+QT -= gui
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# Note: we want to compare our zlib and libdeflate backends, so we always need
+#       libdeflate here...
+
+DEFINES += USE_LIBDEFLATE
+LIBS += -ldeflate
+
+win32: LIBS += -lPsapi
+
+INCLUDEPATH += ../common \
+               ../../src \
+               ../../src/3rdparty/zlib
+
+SOURCES = inflaterbenchmark.cpp \
+          ../common/benchmarkhelpers.cpp \
+          ../../src/inflater.cpp \
+          ../../src/metrics.cpp \
+          ../../src/3rdparty/zlib/adler32.c \
+          ../../src/3rdparty/zlib/crc32.c \
+          ../../src/3rdparty/zlib/deflate.c \
+          ../../src/3rdparty/zlib/inffast.c \
+          ../../src/3rdparty/zlib/inflate.c \
+          ../../src/3rdparty/zlib/inftrees.c \
+          ../../src/3rdparty/zlib/trees.c \
+          ../../src/3rdparty/zlib/zutil.c
+
+HEADERS = ../common/benchmarkhelpers.h \
+          ../../src/inflater.h \
+          ../../src/metrics.h
@@ -0,0 +1,301 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Inflater benchmark
+//==============================================================================
+
+#include "benchmarkhelpers.h"
+#include "inflater.h"
+#include "metrics.h"
+
+//==============================================================================
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtTest>
+
+//==============================================================================
+
+static const qint64 MinimumDuration = 1000;
+
+//==============================================================================
+
+class InflaterBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum Path {
+        ZlibOneShotPath,
+        ZlibStreamingPath,
+        LibdeflatePath
+    };
+
+    QList<QPair<QString, QByteArray>> mPayloads;
+
+    static QByteArray syntheticPayload(int pNbOfSubjects);
+
+    static QByteArray inflated(Path pPath, const QByteArray &pPayload);
+
+    void addRows();
+
+private slots:
+    void initTestCase();
+
+    void multiMember();
+    void corruptData();
+
+    void throughput_data();
+    void throughput();
+
+    void copies_data();
+    void copies();
+
+    void reallocations_data();
+    void reallocations();
+};
+
+//==============================================================================
+
+QByteArray InflaterBenchmark::syntheticPayload(int pNbOfSubjects)
+{
+    // Generate a payload that looks like a page of v2 subjects
+
+    static const QString Subject = "{\"id\":%1,\"object\":\"kanji\",\"url\":\"https://api.wanikani.com/v2/subjects/%1\","
+                                   "\"data_updated_at\":\"2018-03-29T23:13:14.064836Z\",\"data\":{\"level\":%2,"
+                                   "\"characters\":\"%3\",\"meanings\":[{\"meaning\":\"Meaning %1\",\"primary\":true,"
+                                   "\"accepted_answer\":true}],\"readings\":[{\"type\":\"onyomi\",\"primary\":true,"
+                                   "\"accepted_answer\":true,\"reading\":\"reading %4\"}],\"lesson_position\":%5}}";
+
+    QStringList subjects;
+
+    for (int i = 1; i <= pNbOfSubjects; ++i) {
+        subjects << Subject.arg(i)
+                           .arg(1+i%60)
+                           .arg(QChar(0x4e00+i%20000))
+                           .arg(i%97)
+                           .arg(i%50);
+    }
+
+    return QString("{\"object\":\"collection\",\"total_count\":%1,\"data\":[%2]}").arg(pNbOfSubjects)
+                                                                                  .arg(subjects.join(","))
+                                                                                  .toUtf8();
+}
+
+//==============================================================================
+
+QByteArray InflaterBenchmark::inflated(Path pPath, const QByteArray &pPayload)
+{
+    // Uncompress the given payload using the given path
+
+    static const LibdeflateInflaterBackend LibdeflateBackend;
+
+    bool zlibNeeded;
+
+    switch (pPath) {
+    case ZlibOneShotPath:
+        return Inflater::zlibInflated(pPayload);
+    case ZlibStreamingPath:
+        return Inflater::zlibStreamingInflated(pPayload);
+    default:
+        return LibdeflateBackend.inflated(pPayload, zlibNeeded);
+    }
+}
+
+//==============================================================================
+
+void InflaterBenchmark::addRows()
+{
+    // Add a row for each of our payloads and paths
+
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<int>("path");
+
+    for (const auto &payload : mPayloads) {
+        QTest::newRow(qPrintable(payload.first+", zlib one-shot")) << payload.second << int(ZlibOneShotPath);
+        QTest::newRow(qPrintable(payload.first+", zlib streaming")) << payload.second << int(ZlibStreamingPath);
+        QTest::newRow(qPrintable(payload.first+", libdeflate")) << payload.second << int(LibdeflatePath);
+    }
+}
+
+//==============================================================================
+
+void InflaterBenchmark::initTestCase()
+{
+    // Use some synthetic payloads and, if any, the (real) payloads found in the
+    // directory given by WANIKANI_BENCHMARK_PAYLOADS, e.g. as captured using
+    //     curl -H "Accept-Encoding: gzip" -H "Authorization: Bearer <token>" \
+    //          -o subjects.gz https://api.wanikani.com/v2/subjects
+
+    mPayloads << qMakePair(QString("synthetic, 100 subjects"), BenchmarkHelpers::gzipped(syntheticPayload(100)))
+              << qMakePair(QString("synthetic, 1000 subjects"), BenchmarkHelpers::gzipped(syntheticPayload(1000)))
+              << qMakePair(QString("synthetic, 9000 subjects"), BenchmarkHelpers::gzipped(syntheticPayload(9000)));
+
+    QString payloadsPath = qEnvironmentVariable("WANIKANI_BENCHMARK_PAYLOADS");
+    QDir payloadsDir(payloadsPath);
+
+    if (!payloadsPath.isEmpty() && payloadsDir.exists()) {
+        for (const auto &fileName : payloadsDir.entryList(QStringList() << "*.gz", QDir::Files)) {
+            QFile file(payloadsDir.filePath(fileName));
+
+            if (file.open(QIODevice::ReadOnly)) {
+                mPayloads << qMakePair(fileName, file.readAll());
+            }
+        }
+    }
+}
+
+//==============================================================================
+
+void InflaterBenchmark::multiMember()
+{
+    // Make sure that a multi-member payload is fully uncompressed
+
+    QByteArray part1 = syntheticPayload(10);
+    QByteArray part2 = syntheticPayload(20);
+    QByteArray payload = BenchmarkHelpers::gzipped(part1)+BenchmarkHelpers::gzipped(part2);
+
+    QCOMPARE(Inflater::zlibInflated(payload), part1+part2);
+    QCOMPARE(Inflater::zlibStreamingInflated(payload), part1+part2);
+
+    LibdeflateInflaterBackend libdeflateBackend;
+    bool zlibNeeded;
+
+    QVERIFY(libdeflateBackend.inflated(payload, zlibNeeded).isEmpty());
+    QVERIFY(zlibNeeded);
+    QCOMPARE(Inflater::inflated(libdeflateBackend, payload), part1+part2);
+}
+
+//==============================================================================
+
+void InflaterBenchmark::corruptData()
+{
+    // Make sure that corrupt data (here, data with a wrong CRC32) is not
+    // handed over to zlib
+
+    QByteArray payload = BenchmarkHelpers::gzipped(syntheticPayload(10));
+    int crc32Position = payload.size()-8;
+
+    payload[crc32Position] = char(~payload[crc32Position]);
+
+    bool zlibNeeded;
+
+    QVERIFY(LibdeflateInflaterBackend().inflated(payload, zlibNeeded).isEmpty());
+    QVERIFY(!zlibNeeded);
+}
+
+//==============================================================================
+
+void InflaterBenchmark::throughput_data()
+{
+    // Our throughput data
+
+    addRows();
+}
+
+//==============================================================================
+
+void InflaterBenchmark::throughput()
+{
+    // Make sure that the given path (i.e. backend) gives the right result and
+    // then determine its throughput, in uncompressed bytes per second
+
+    QFETCH(QByteArray, payload);
+    QFETCH(int, path);
+
+    QByteArray expected = Inflater::zlibStreamingInflated(payload);
+
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(inflated(Path(path), payload), expected);
+
+    QElapsedTimer timer;
+    qint64 nbOfBytes = 0;
+
+    timer.start();
+
+    do {
+        nbOfBytes += inflated(Path(path), payload).size();
+    } while (timer.elapsed() < MinimumDuration);
+
+    QTest::setBenchmarkResult(1.0e9*nbOfBytes/timer.nsecsElapsed(), QTest::BytesPerSecond);
+}
+
+//==============================================================================
+
+void InflaterBenchmark::copies_data()
+{
+    // Our copies data
+
+    addRows();
+}
+
+//==============================================================================
+
+void InflaterBenchmark::copies()
+{
+    // Determine how many times the given path copies a chunk of uncompressed
+    // data into its result
+
+    QFETCH(QByteArray, payload);
+    QFETCH(int, path);
+
+    qint64 nbOfAppends = Metrics::instance()->value(Metrics::StreamingInflateAppends);
+
+    inflated(Path(path), payload);
+
+    QTest::setBenchmarkResult(Metrics::instance()->value(Metrics::StreamingInflateAppends)-nbOfAppends, QTest::Events);
+}
+
+//==============================================================================
+
+void InflaterBenchmark::reallocations_data()
+{
+    // Our reallocations data
+
+    addRows();
+}
+
+//==============================================================================
+
+void InflaterBenchmark::reallocations()
+{
+    // Determine how many times the given path reallocates its result
+
+    QFETCH(QByteArray, payload);
+    QFETCH(int, path);
+
+    qint64 nbOfReallocations = Metrics::instance()->value(Metrics::StreamingInflateReallocations);
+
+    inflated(Path(path), payload);
+
+    QTest::setBenchmarkResult(Metrics::instance()->value(Metrics::StreamingInflateReallocations)-nbOfReallocations, QTest::Events);
+}
+
+//==============================================================================
+
+QTEST_APPLESS_MAIN(InflaterBenchmark)
+
+//==============================================================================
+
+#include "inflaterbenchmark.moc"
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,212 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Aggregation
+//==============================================================================
+
+#include "aggregation.h"
+
+//==============================================================================
+
+Aggregation::Aggregation() :
+    mCurrentRadicalsReviews(Reviews()),
+    mAllRadicalsReviews(Reviews()),
+    mCurrentKanjiReviews(Reviews()),
+    mAllKanjiReviews(Reviews()),
+    mCurrentVocabularyReviews(Reviews()),
+    mAllVocabularyReviews(Reviews()),
+    mCurrentKanjiState(QMap<QChar, QString>()),
+    mAllKanjiState(QMap<QChar, QString>()),
+    mLevelStartTime(0)
+{
+}
+
+//==============================================================================
+
+void Aggregation::aggregate(const Snapshot &pSnapshot,
+                            LevelUpProjection &pLevelUpProjection,
+                            WorkloadForecast &pWorkloadForecast)
+{
+    // Go, in one pass, through the columns of our items to retrieve our
+    // reviews, the state of our Kanji, what the given level up projection and
+    // workload forecast need, and when we started our current level
+    // Note: our user level is the same for all our items, so we retrieve it
+    //       once and for all. Similarly, we retrieve our columns once and for
+    //       all, so that our loop only reads the columns it needs rather than
+    //       whole items...
+
+    int userLevel = pSnapshot.user().level();
+
+    mCurrentRadicalsReviews = Reviews();
+    mAllRadicalsReviews = Reviews();
+
+    mCurrentKanjiState = QMap<QChar, QString>();
+    mAllKanjiState = QMap<QChar, QString>();
+
+    mCurrentKanjiReviews = Reviews();
+    mAllKanjiReviews = Reviews();
+
+    mCurrentVocabularyReviews = Reviews();
+    mAllVocabularyReviews = Reviews();
+
+    mLevelStartTime = 0;
+
+    pLevelUpProjection.reset(userLevel);
+    pWorkloadForecast.reset();
+
+    const ItemColumns &itemColumns = pSnapshot.itemColumns();
+    const int *types = itemColumns.types().constData();
+    const int *levels = itemColumns.levels().constData();
+    const int *srsLevels = itemColumns.srsLevels().constData();
+    const uint *unlockedDates = itemColumns.unlockedDates().constData();
+    const uint *availableDates = itemColumns.availableDates().constData();
+    const int *correct = itemColumns.correct().constData();
+    const int *incorrect = itemColumns.incorrect().constData();
+    const QChar *characters = itemColumns.characters().constData();
+    const QString *srs = itemColumns.srs().constData();
+    Reviews *currentReviews[ItemColumns::NbOfItemTypes] = { &mCurrentRadicalsReviews,
+                                                            &mCurrentKanjiReviews,
+                                                            &mCurrentVocabularyReviews };
+    Reviews *allReviews[ItemColumns::NbOfItemTypes] = { &mAllRadicalsReviews,
+                                                        &mAllKanjiReviews,
+                                                        &mAllVocabularyReviews };
+
+    for (int i = 0, iMax = itemColumns.count(); i < iMax; ++i) {
+        ItemColumns::ItemType type = ItemColumns::ItemType(types[i]);
+        int level = levels[i];
+        bool currentLevel = level == userLevel;
+        uint availableDate = availableDates[i];
+
+        pLevelUpProjection.add(type, level, srsLevels[i], unlockedDates[i],
+                               availableDate, correct[i], incorrect[i]);
+        pWorkloadForecast.add(type, level, srsLevels[i], unlockedDates[i],
+                              availableDate);
+
+        if ((type == ItemColumns::RadicalType) && currentLevel) {
+            // A radical from our current level, so retrieve, if needed, when we
+            // started our current level
+
+            if (   !mLevelStartTime
+                ||  (unlockedDates[i] && (unlockedDates[i] < mLevelStartTime))) {
+                mLevelStartTime = unlockedDates[i];
+            }
+        } else if (type == ItemColumns::KanjiType) {
+            if (level <= userLevel) {
+                mCurrentKanjiState.insert(characters[i], srs[i]);
+            }
+
+            mAllKanjiState.insert(characters[i], srs[i]);
+        }
+
+        if (availableDate) {
+            qint64 time = availableDate;
+
+            if (currentLevel) {
+                ++(*currentReviews[type])[time];
+            }
+
+            ++(*allReviews[type])[time];
+        }
+    }
+}
+
+//==============================================================================
+
+const Reviews & Aggregation::currentRadicalsReviews() const
+{
+    // Return our current radicals reviews
+
+    return mCurrentRadicalsReviews;
+}
+
+//==============================================================================
+
+const Reviews & Aggregation::allRadicalsReviews() const
+{
+    // Return all our radicals reviews
+
+    return mAllRadicalsReviews;
+}
+
+//==============================================================================
+
+const Reviews & Aggregation::currentKanjiReviews() const
+{
+    // Return our current Kanji reviews
+
+    return mCurrentKanjiReviews;
+}
+
+//==============================================================================
+
+const Reviews & Aggregation::allKanjiReviews() const
+{
+    // Return all our Kanji reviews
+
+    return mAllKanjiReviews;
+}
+
+//==============================================================================
+
+const Reviews & Aggregation::currentVocabularyReviews() const
+{
+    // Return our current vocabulary reviews
+
+    return mCurrentVocabularyReviews;
+}
+
+//==============================================================================
+
+const Reviews & Aggregation::allVocabularyReviews() const
+{
+    // Return all our vocabulary reviews
+
+    return mAllVocabularyReviews;
+}
+
+//==============================================================================
+
+const QMap<QChar, QString> & Aggregation::currentKanjiState() const
+{
+    // Return the state of our current Kanji
+
+    return mCurrentKanjiState;
+}
+
+//==============================================================================
+
+const QMap<QChar, QString> & Aggregation::allKanjiState() const
+{
+    // Return the state of all our Kanji
+
+    return mAllKanjiState;
+}
+
+//==============================================================================
+
+qint64 Aggregation::levelStartTime() const
+{
+    // Return when we started our current level, if known
+
+    return mLevelStartTime;
+}
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,81 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Aggregation
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "levelupprojection.h"
+#include "workloadforecast.h"
+
+//==============================================================================
+
+#include <QMap>
+
+//==============================================================================
+
+typedef QMap<qint64, int> Reviews;
+
+//==============================================================================
+
+class Aggregation
+{
+public:
+    explicit Aggregation();
+
+    void aggregate(const Snapshot &pSnapshot,
+                   LevelUpProjection &pLevelUpProjection,
+                   WorkloadForecast &pWorkloadForecast);
+
+    const Reviews & currentRadicalsReviews() const;
+    const Reviews & allRadicalsReviews() const;
+
+    const Reviews & currentKanjiReviews() const;
+    const Reviews & allKanjiReviews() const;
+
+    const Reviews & currentVocabularyReviews() const;
+    const Reviews & allVocabularyReviews() const;
+
+    const QMap<QChar, QString> & currentKanjiState() const;
+    const QMap<QChar, QString> & allKanjiState() const;
+
+    qint64 levelStartTime() const;
+
+private:
+    Reviews mCurrentRadicalsReviews;
+    Reviews mAllRadicalsReviews;
+
+    Reviews mCurrentKanjiReviews;
+    Reviews mAllKanjiReviews;
+
+    Reviews mCurrentVocabularyReviews;
+    Reviews mAllVocabularyReviews;
+
+    QMap<QChar, QString> mCurrentKanjiState;
+    QMap<QChar, QString> mAllKanjiState;
+
+    qint64 mLevelStartTime;
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
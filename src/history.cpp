@@ -0,0 +1,866 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// History
+//==============================================================================
+
+#include "history.h"
+#include "metrics.h"
+
+//==============================================================================
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+//==============================================================================
+
+#include <algorithm>
+
+//==============================================================================
+
+#include "zlib.h"
+
+//==============================================================================
+
+static const quint32 HistoryFileMagic = 0x574b4853;
+static const quint32 HistoryFileVersion = 2;
+
+static const qint64 FileHeaderSize = 8;
+static const qint64 RecordHeaderSize = 20;
+
+static const qint64 MaxFileSize = 1 << 20;
+static const qint64 RetentionTime = 90*86400;
+
+static const quint8 RemovedSrsLevel = 0xff;
+
+//==============================================================================
+
+static void writeVarint(QByteArray &pData, quint64 pValue)
+{
+    // Write the given value as a variable-length integer
+
+    while (pValue >= 0x80) {
+        pData += char((pValue & 0x7f) | 0x80);
+
+        pValue >>= 7;
+    }
+
+    pData += char(pValue);
+}
+
+//==============================================================================
+
+static bool readVarint(const uchar *&pData, const uchar *pEnd, quint64 &pValue)
+{
+    // Read a variable-length integer and return whether we could
+
+    pValue = 0;
+
+    for (int shift = 0; (pData != pEnd) && (shift < 64); shift += 7) {
+        uchar byte = *pData++;
+
+        pValue |= quint64(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+static History::Summary snapshotSummary(const Snapshot &pSnapshot, qint64 pTime)
+{
+    // Summarise the given snapshot
+
+    History::Summary res;
+
+    res.time = pTime;
+    res.level = pSnapshot.user().level();
+    res.lessonsAvailable = pSnapshot.studyQueue().lessonsAvailable();
+    res.reviewsAvailable = pSnapshot.studyQueue().reviewsAvailable();
+    res.radicalsProgress = pSnapshot.levelProgression().radicalsProgress();
+    res.radicalsTotal = pSnapshot.levelProgression().radicalsTotal();
+    res.kanjiProgress = pSnapshot.levelProgression().kanjiProgress();
+    res.kanjiTotal = pSnapshot.levelProgression().kanjiTotal();
+
+    const SrsDistribution &srsDistribution = pSnapshot.srsDistribution();
+    const SrsDistributionInformation informations[History::NbOfSrsStages] = {
+        srsDistribution.apprentice(),
+        srsDistribution.guru(),
+        srsDistribution.master(),
+        srsDistribution.enlightened(),
+        srsDistribution.burned()
+    };
+
+    for (int i = 0; i < History::NbOfSrsStages; ++i) {
+        res.srsDistribution[i][History::RadicalType] = informations[i].radicals().toInt();
+        res.srsDistribution[i][History::KanjiType] = informations[i].kanji().toInt();
+        res.srsDistribution[i][History::VocabularyType] = informations[i].vocabulary().toInt();
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+static bool sameSummaries(const History::Summary &pSummary1,
+                          const History::Summary &pSummary2)
+{
+    // Return whether the two given summaries are the same, time apart
+
+    return    (pSummary1.level == pSummary2.level)
+           && (pSummary1.lessonsAvailable == pSummary2.lessonsAvailable)
+           && (pSummary1.reviewsAvailable == pSummary2.reviewsAvailable)
+           && (pSummary1.radicalsProgress == pSummary2.radicalsProgress)
+           && (pSummary1.radicalsTotal == pSummary2.radicalsTotal)
+           && (pSummary1.kanjiProgress == pSummary2.kanjiProgress)
+           && (pSummary1.kanjiTotal == pSummary2.kanjiTotal)
+           && std::equal(&pSummary1.srsDistribution[0][0],
+                         &pSummary1.srsDistribution[0][0]+History::NbOfSrsStages*History::NbOfItemTypes,
+                         &pSummary2.srsDistribution[0][0]);
+}
+
+//==============================================================================
+
+History::History() :
+    mAccount(QString()),
+    mLoaded(false),
+    mSize(0),
+    mCompactedSize(0),
+    mNbOfRecords(0),
+    mSrsLevels(QHash<quint64, quint8>()),
+    mLastSummary(Summary())
+{
+}
+
+//==============================================================================
+
+quint64 History::itemKey(ItemType pItemType, const Item &pItem)
+{
+    // Return a key for the given item, based on its type and (v2) subject id
+    // or, for a v1 item, on a CRC-32 of its characters (or of its meaning, for
+    // a radical that only has an image), with bit 32 set so that it cannot
+    // clash with a subject id
+    // Note: unlike qHash(), CRC-32 gives the same value whatever the platform
+    //       and version of Qt, which matters since our keys end up in our
+    //       history file...
+
+    if (pItem.id()) {
+        return (quint64(pItemType) << 33) | quint64(pItem.id());
+    }
+
+    QByteArray characters = (pItem.characters().isEmpty()?pItem.meaning():pItem.characters()).toUtf8();
+
+    return   (quint64(pItemType) << 33) | (Q_UINT64_C(1) << 32)
+           | crc32(0, reinterpret_cast<const Bytef *>(characters.constData()), uInt(characters.size()));
+}
+
+//==============================================================================
+
+History::ItemType History::itemType(quint64 pItemKey)
+{
+    // Return the type of the item which key is given
+
+    return ItemType(pItemKey >> 33);
+}
+
+//==============================================================================
+
+int History::subjectId(quint64 pItemKey)
+{
+    // Return the (v2) subject id of the item which key is given, or zero if it
+    // is a v1 item
+
+    return (pItemKey & (Q_UINT64_C(1) << 32))?0:int(pItemKey & 0xffffffff);
+}
+
+//==============================================================================
+
+void History::append(const Snapshot &pSnapshot, qint64 pTime)
+{
+    // Make sure that we keep track of the history of the snapshot's account
+    // Note: we don't know whose snapshot it is until the user's information
+    //       has been retrieved, in which case there is nothing to record...
+
+    QString account = pSnapshot.user().userName();
+
+    if (account.isEmpty()) {
+        return;
+    }
+
+    setAccount(account);
+    load();
+
+    // Retrieve the SRS level of all our items
+
+    SrsLevels srsLevels;
+
+    srsLevels.reserve(pSnapshot.radicals().count()+pSnapshot.kanjis().count()+pSnapshot.vocabularies().count());
+
+    for (const auto &radical : pSnapshot.radicals()) {
+        srsLevels << SrsLevel(itemKey(RadicalType, radical), quint8(radical.userSpecific().srsNumeric()));
+    }
+
+    for (const auto &kanji : pSnapshot.kanjis()) {
+        srsLevels << SrsLevel(itemKey(KanjiType, kanji), quint8(kanji.userSpecific().srsNumeric()));
+    }
+
+    for (const auto &vocabulary : pSnapshot.vocabularies()) {
+        srsLevels << SrsLevel(itemKey(VocabularyType, vocabulary), quint8(vocabulary.userSpecific().srsNumeric()));
+    }
+
+    std::sort(srsLevels.begin(), srsLevels.end());
+
+    // Determine which of our items have been added or have changed since our
+    // last record, as well as which of them have been removed, unless our
+    // snapshot doesn't have any item, in which case they have yet to be
+    // retrieved rather than all been removed
+
+    SrsLevels transitions;
+
+    for (const auto &srsLevel : srsLevels) {
+        auto oldSrsLevel = mSrsLevels.constFind(srsLevel.first);
+
+        if (   (oldSrsLevel == mSrsLevels.constEnd())
+            || (oldSrsLevel.value() != srsLevel.second)) {
+            transitions << srsLevel;
+        }
+    }
+
+    if (!srsLevels.isEmpty()) {
+        bool removedItems = false;
+
+        for (auto oldSrsLevel = mSrsLevels.constBegin(), endOldSrsLevel = mSrsLevels.constEnd();
+             oldSrsLevel != endOldSrsLevel; ++oldSrsLevel) {
+            if (!std::binary_search(srsLevels.constBegin(), srsLevels.constEnd(),
+                                    SrsLevel(oldSrsLevel.key(), 0),
+                                    [](const SrsLevel &pSrsLevel1, const SrsLevel &pSrsLevel2) {
+                                        return pSrsLevel1.first < pSrsLevel2.first;
+                                    })) {
+                transitions << SrsLevel(oldSrsLevel.key(), RemovedSrsLevel);
+
+                removedItems = true;
+            }
+        }
+
+        if (removedItems) {
+            std::sort(transitions.begin(), transitions.end());
+        }
+    }
+
+    // Append a record, unless nothing has changed since our last record
+    // Note: our first record is a keyframe, i.e. it has the SRS level of all
+    //       our items rather than only of those that have changed...
+
+    Summary summary = snapshotSummary(pSnapshot, pTime);
+    bool keyframe = !mNbOfRecords;
+
+    if (!keyframe && transitions.isEmpty() && sameSummaries(summary, mLastSummary)) {
+        return;
+    }
+
+    QByteArray record = encodedRecord(pTime, keyframe?KeyframeRecord:DeltaRecord,
+                                      summary, keyframe?srsLevels:transitions);
+
+    if (record.isEmpty()) {
+        return;
+    }
+
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+
+    QFile file(fileName());
+
+    if (!file.open(QIODevice::ReadWrite)) {
+        return;
+    }
+
+    // Make sure that our file starts with our header and doesn't end with an
+    // incomplete record, before appending our record to it
+
+    if (!mSize) {
+        QByteArray header;
+        QDataStream stream(&header, QIODevice::WriteOnly);
+
+        stream.setVersion(QDataStream::Qt_5_0);
+
+        stream << HistoryFileMagic << HistoryFileVersion;
+
+        file.resize(0);
+
+        if (file.write(header) != header.size()) {
+            return;
+        }
+
+        mSize = FileHeaderSize;
+    } else if (file.size() != mSize) {
+        file.resize(mSize);
+    }
+
+    file.seek(mSize);
+
+    if (file.write(record) != record.size()) {
+        file.resize(mSize);
+
+        return;
+    }
+
+    file.close();
+
+    mSize += record.size();
+
+    ++mNbOfRecords;
+
+    replay(mSrsLevels, transitions);
+
+    mLastSummary = summary;
+
+    // Compact ourselves, if we have grown too much since we were last
+    // compacted
+
+    if (mSize > qMax(MaxFileSize, 2*mCompactedSize)) {
+        compact(pTime);
+    }
+}
+
+//==============================================================================
+
+QVector<History::Summary> History::summaries(qint64 pFrom, qint64 pTo)
+{
+    // Return the summaries recorded within the given time range
+
+    load();
+
+    QVector<Summary> res;
+    QFile file(fileName());
+
+    if (!mSize || !file.open(QIODevice::ReadOnly)) {
+        return res;
+    }
+
+    uchar *data = file.map(0, mSize);
+
+    if (!data) {
+        return res;
+    }
+
+    QByteArray mappedData = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(mSize));
+    qint64 size = 0;
+
+    for (const auto &record : records(mappedData, size)) {
+        if (record.time > pTo) {
+            break;
+        }
+
+        Summary summary;
+        SrsLevels srsLevels;
+
+        if ((record.time >= pFrom) && readRecord(mappedData, record, summary, srsLevels)) {
+            res << summary;
+        }
+    }
+
+    file.unmap(data);
+
+    return res;
+}
+
+//==============================================================================
+
+QVector<History::Transition> History::transitions(qint64 pFrom, qint64 pTo)
+{
+    // Return the SRS transitions recorded within the given time range, with an
+    // SRS level of -1 for an item that has been removed
+    // Note: a keyframe has the SRS level of all our items rather than their
+    //       transitions, so we skip it...
+
+    load();
+
+    QVector<Transition> res;
+    QFile file(fileName());
+
+    if (!mSize || !file.open(QIODevice::ReadOnly)) {
+        return res;
+    }
+
+    uchar *data = file.map(0, mSize);
+
+    if (!data) {
+        return res;
+    }
+
+    QByteArray mappedData = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(mSize));
+    qint64 size = 0;
+
+    for (const auto &record : records(mappedData, size)) {
+        if (record.time > pTo) {
+            break;
+        }
+
+        Summary summary;
+        SrsLevels srsLevels;
+
+        if (   (record.time >= pFrom) && (record.kind == DeltaRecord)
+            && readRecord(mappedData, record, summary, srsLevels)) {
+            for (const auto &srsLevel : srsLevels) {
+                res << Transition { record.time, srsLevel.first,
+                                    (srsLevel.second == RemovedSrsLevel)?-1:srsLevel.second };
+            }
+        }
+    }
+
+    file.unmap(data);
+
+    return res;
+}
+
+//==============================================================================
+
+int History::nbOfRecords() const
+{
+    // Return our number of records
+    // Note: we may be appending a record in another thread, hence our number
+    //       of records is atomic and we don't load ourselves here...
+
+    return mNbOfRecords;
+}
+
+//==============================================================================
+
+qint64 History::size() const
+{
+    // Return our size
+    // Note: see nbOfRecords()...
+
+    return mSize;
+}
+
+//==============================================================================
+
+QString History::fileName() const
+{
+    // Return the name of the file in which we keep the history of our account
+    // Note: our account is hashed so that it doesn't end up in a file name...
+
+    return  QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)+QDir::separator()
+           +QString("history-%1.dat").arg(QString(QCryptographicHash::hash(mAccount.toUtf8(), QCryptographicHash::Sha1).toHex().left(16)));
+}
+
+//==============================================================================
+
+void History::replay(QHash<quint64, quint8> &pSrsLevels,
+                     const SrsLevels &pRecordSrsLevels)
+{
+    // Replay the SRS levels of a record, i.e. update or remove our items
+
+    for (const auto &srsLevel : pRecordSrsLevels) {
+        if (srsLevel.second == RemovedSrsLevel) {
+            pSrsLevels.remove(srsLevel.first);
+        } else {
+            pSrsLevels.insert(srsLevel.first, srsLevel.second);
+        }
+    }
+}
+
+//==============================================================================
+
+QVector<History::Record> History::records(const QByteArray &pData,
+                                          qint64 &pSize)
+{
+    // Retrieve the header of all the complete records in the given data, if it
+    // is compatible with us, as well as the size of those records (including
+    // our file header)
+    // Note: our records are skipped rather than read, so this is cheap even
+    //       for a large history...
+
+    QVector<Record> res;
+    QDataStream stream(pData);
+    quint32 magic = 0;
+    quint32 version = 0;
+
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream >> magic >> version;
+
+    pSize = 0;
+
+    if ((magic != HistoryFileMagic) || (version != HistoryFileVersion)) {
+        return res;
+    }
+
+    pSize = FileHeaderSize;
+
+    while (pSize+RecordHeaderSize <= pData.size()) {
+        Record record;
+
+        stream >> record.time >> record.kind >> record.rawSize >> record.compressedSize;
+
+        record.offset = pSize+RecordHeaderSize;
+
+        if (record.offset+record.compressedSize > pData.size()) {
+            break;
+        }
+
+        stream.skipRawData(int(record.compressedSize));
+
+        res << record;
+
+        pSize = record.offset+record.compressedSize;
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+bool History::readRecord(const QByteArray &pData, const Record &pRecord,
+                         Summary &pSummary, SrsLevels &pSrsLevels)
+{
+    // Uncompress the given record
+
+    QByteArray raw(int(pRecord.rawSize), Qt::Uninitialized);
+    uLongf rawSize = pRecord.rawSize;
+
+    if (   (uncompress(reinterpret_cast<Bytef *>(raw.data()), &rawSize,
+                       reinterpret_cast<const Bytef *>(pData.constData()+pRecord.offset),
+                       pRecord.compressedSize) != Z_OK)
+        || (rawSize != pRecord.rawSize)) {
+        return false;
+    }
+
+    // Read our summary and (delta-encoded) SRS levels
+
+    QDataStream stream(raw);
+    QByteArray srsLevels;
+
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    pSummary.time = pRecord.time;
+
+    stream >> pSummary.level >> pSummary.lessonsAvailable >> pSummary.reviewsAvailable
+           >> pSummary.radicalsProgress >> pSummary.radicalsTotal
+           >> pSummary.kanjiProgress >> pSummary.kanjiTotal;
+
+    for (int i = 0; i < NbOfSrsStages; ++i) {
+        for (int j = 0; j < NbOfItemTypes; ++j) {
+            stream >> pSummary.srsDistribution[i][j];
+        }
+    }
+
+    stream >> srsLevels;
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    const uchar *data = reinterpret_cast<const uchar *>(srsLevels.constData());
+    const uchar *dataEnd = data+srsLevels.size();
+    quint64 nbOfSrsLevels = 0;
+    quint64 item = 0;
+
+    if (!readVarint(data, dataEnd, nbOfSrsLevels)) {
+        return false;
+    }
+
+    pSrsLevels.clear();
+    pSrsLevels.reserve(int(qMin(nbOfSrsLevels, quint64(srsLevels.size()))));
+
+    for (quint64 i = 0; i < nbOfSrsLevels; ++i) {
+        quint64 itemDelta = 0;
+
+        if (!readVarint(data, dataEnd, itemDelta) || (data == dataEnd)) {
+            return false;
+        }
+
+        item += itemDelta;
+
+        pSrsLevels << SrsLevel(item, *data++);
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+QByteArray History::encodedRecord(qint64 pTime, RecordKind pKind,
+                                  const Summary &pSummary,
+                                  const SrsLevels &pSrsLevels)
+{
+    // Delta-encode the given SRS levels, which are sorted by item
+
+    QByteArray srsLevels;
+    quint64 previousItem = 0;
+
+    writeVarint(srsLevels, quint64(pSrsLevels.count()));
+
+    for (const auto &srsLevel : pSrsLevels) {
+        writeVarint(srsLevels, srsLevel.first-previousItem);
+
+        srsLevels += char(srsLevel.second);
+
+        previousItem = srsLevel.first;
+    }
+
+    // Write our summary and SRS levels, and compress them
+
+    QByteArray raw;
+    QDataStream stream(&raw, QIODevice::WriteOnly);
+
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << pSummary.level << pSummary.lessonsAvailable << pSummary.reviewsAvailable
+           << pSummary.radicalsProgress << pSummary.radicalsTotal
+           << pSummary.kanjiProgress << pSummary.kanjiTotal;
+
+    for (int i = 0; i < NbOfSrsStages; ++i) {
+        for (int j = 0; j < NbOfItemTypes; ++j) {
+            stream << pSummary.srsDistribution[i][j];
+        }
+    }
+
+    stream << srsLevels;
+
+    uLongf compressedSize = compressBound(uLong(raw.size()));
+    QByteArray compressed(int(compressedSize), Qt::Uninitialized);
+
+    if (compress2(reinterpret_cast<Bytef *>(compressed.data()), &compressedSize,
+                  reinterpret_cast<const Bytef *>(raw.constData()), uLong(raw.size()),
+                  Z_BEST_COMPRESSION) != Z_OK) {
+        return QByteArray();
+    }
+
+    compressed.resize(int(compressedSize));
+
+    // Return our record, i.e. its header followed by its compressed data
+
+    QByteArray res;
+    QDataStream recordStream(&res, QIODevice::WriteOnly);
+
+    recordStream.setVersion(QDataStream::Qt_5_0);
+
+    recordStream << pTime << quint32(pKind) << quint32(raw.size()) << quint32(compressed.size());
+
+    return res+compressed;
+}
+
+//==============================================================================
+
+void History::setAccount(const QString &pAccount)
+{
+    // Keep track of the given account, starting afresh if it isn't the one we
+    // have been keeping track of, so that we never mix the history of
+    // different accounts
+
+    if (!pAccount.compare(mAccount)) {
+        return;
+    }
+
+    mAccount = pAccount;
+
+    mLoaded = false;
+
+    mSize = 0;
+    mCompactedSize = 0;
+    mNbOfRecords = 0;
+
+    mSrsLevels.clear();
+    mLastSummary = Summary();
+}
+
+//==============================================================================
+
+void History::load()
+{
+    // Retrieve the size of our history and the SRS level of all our items, as
+    // well as our last summary, replaying our records from our last keyframe
+    // Note: a record that cannot be read means that our history has been
+    //       corrupted, so we drop it and all the records after it...
+
+    if (mLoaded) {
+        return;
+    }
+
+    mLoaded = true;
+
+    // Remove our version 1 history, if any, since it was shared by all
+    // accounts and its item keys were not stable
+
+    QFile::remove(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)+QDir::separator()+"history.dat");
+
+    // Retrieve our history
+
+    QFile file(fileName());
+
+    if (!file.open(QIODevice::ReadOnly) || !file.size()) {
+        return;
+    }
+
+    uchar *data = file.map(0, file.size());
+
+    if (!data) {
+        return;
+    }
+
+    QByteArray mappedData = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(file.size()));
+    qint64 size = 0;
+    QVector<Record> records = History::records(mappedData, size);
+    int keyframe = records.count()-1;
+
+    while ((keyframe > 0) && (records[keyframe].kind != KeyframeRecord)) {
+        --keyframe;
+    }
+
+    mSize = size;
+    mNbOfRecords = records.count();
+
+    for (int i = qMax(keyframe, 0), iMax = records.count(); i < iMax; ++i) {
+        Summary summary;
+        SrsLevels srsLevels;
+
+        if (!readRecord(mappedData, records[i], summary, srsLevels)) {
+            mSize = records[i].offset-RecordHeaderSize;
+            mNbOfRecords = i;
+
+            break;
+        }
+
+        if (records[i].kind == KeyframeRecord) {
+            mSrsLevels.clear();
+        }
+
+        replay(mSrsLevels, srsLevels);
+
+        mLastSummary = summary;
+    }
+
+    mCompactedSize = mSize;
+
+    file.unmap(data);
+}
+
+//==============================================================================
+
+void History::compact(qint64 pTime)
+{
+    // Compact our history by only keeping the last record of each day for the
+    // records that are older than our retention time, with the last of those
+    // records becoming a keyframe, so that we don't lose track of the SRS
+    // level of our items
+    // Note: our other records are copied as is, i.e. without being
+    //       uncompressed and compressed again...
+
+    QFile file(fileName());
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    uchar *data = file.map(0, mSize);
+
+    if (!data) {
+        return;
+    }
+
+    QByteArray mappedData = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(mSize));
+    qint64 size = 0;
+    QVector<Record> records = History::records(mappedData, size);
+    qint64 cutoffTime = pTime-RetentionTime;
+    QByteArray compactedData = mappedData.left(int(FileHeaderSize));
+    QHash<quint64, quint8> srsLevels;
+    int nbOfRecords = 0;
+
+    for (int i = 0, iMax = records.count(); i < iMax; ++i) {
+        const Record &record = records[i];
+
+        if (record.time >= cutoffTime) {
+            compactedData.append(mappedData.constData()+record.offset-RecordHeaderSize,
+                                 int(RecordHeaderSize+record.compressedSize));
+
+            ++nbOfRecords;
+
+            continue;
+        }
+
+        Summary summary;
+        SrsLevels recordSrsLevels;
+
+        if (!readRecord(mappedData, record, summary, recordSrsLevels)) {
+            file.unmap(data);
+
+            return;
+        }
+
+        if (record.kind == KeyframeRecord) {
+            srsLevels.clear();
+        }
+
+        replay(srsLevels, recordSrsLevels);
+
+        if ((i == iMax-1) || (records[i+1].time >= cutoffTime)) {
+            SrsLevels keyframeSrsLevels;
+
+            keyframeSrsLevels.reserve(srsLevels.count());
+
+            for (auto srsLevel = srsLevels.constBegin(), endSrsLevel = srsLevels.constEnd();
+                 srsLevel != endSrsLevel; ++srsLevel) {
+                keyframeSrsLevels << SrsLevel(srsLevel.key(), srsLevel.value());
+            }
+
+            std::sort(keyframeSrsLevels.begin(), keyframeSrsLevels.end());
+
+            compactedData += encodedRecord(record.time, KeyframeRecord, summary, keyframeSrsLevels);
+
+            ++nbOfRecords;
+        } else if (record.time/86400 != records[i+1].time/86400) {
+            compactedData += encodedRecord(record.time, DeltaRecord, summary, SrsLevels());
+
+            ++nbOfRecords;
+        }
+    }
+
+    file.unmap(data);
+    file.close();
+
+    // Replace our history with its compacted version
+    // Note: whether we succeed or not, we don't want to try again until we
+    //       have grown quite a bit...
+
+    QSaveFile compactedFile(fileName());
+
+    if (   compactedFile.open(QIODevice::WriteOnly)
+        && (compactedFile.write(compactedData) == compactedData.size())
+        && compactedFile.commit()) {
+        mSize = compactedData.size();
+        mNbOfRecords = nbOfRecords;
+
+        Metrics::instance()->add(Metrics::HistoryCompactions);
+    }
+
+    mCompactedSize = mSize;
+}
+
+//==============================================================================
+// End of file
+//==============================================================================
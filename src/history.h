@@ -0,0 +1,137 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// History
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "wanikani.h"
+
+//==============================================================================
+
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
+//==============================================================================
+
+#include <atomic>
+
+//==============================================================================
+
+class History
+{
+public:
+    enum ItemType {
+        RadicalType,
+        KanjiType,
+        VocabularyType,
+        NbOfItemTypes
+    };
+
+    enum {
+        NbOfSrsStages = 5
+    };
+
+    struct Summary
+    {
+        qint64 time = 0;
+        int level = 0;
+        int lessonsAvailable = 0;
+        int reviewsAvailable = 0;
+        int radicalsProgress = 0;
+        int radicalsTotal = 0;
+        int kanjiProgress = 0;
+        int kanjiTotal = 0;
+        int srsDistribution[NbOfSrsStages][NbOfItemTypes] = {};
+    };
+
+    struct Transition
+    {
+        qint64 time;
+        quint64 item;
+        int srsLevel;
+    };
+
+    explicit History();
+
+    static quint64 itemKey(ItemType pItemType, const Item &pItem);
+    static ItemType itemType(quint64 pItemKey);
+    static int subjectId(quint64 pItemKey);
+
+    void append(const Snapshot &pSnapshot, qint64 pTime);
+
+    QVector<Summary> summaries(qint64 pFrom, qint64 pTo);
+    QVector<Transition> transitions(qint64 pFrom, qint64 pTo);
+
+    int nbOfRecords() const;
+    qint64 size() const;
+
+private:
+    enum RecordKind {
+        KeyframeRecord,
+        DeltaRecord
+    };
+
+    struct Record
+    {
+        qint64 time;
+        quint32 kind;
+        quint32 rawSize;
+        quint32 compressedSize;
+        qint64 offset;
+    };
+
+    typedef QPair<quint64, quint8> SrsLevel;
+    typedef QVector<SrsLevel> SrsLevels;
+
+    QString mAccount;
+
+    bool mLoaded;
+
+    std::atomic<qint64> mSize;
+    qint64 mCompactedSize;
+    std::atomic<int> mNbOfRecords;
+
+    QHash<quint64, quint8> mSrsLevels;
+    Summary mLastSummary;
+
+    QString fileName() const;
+
+    static void replay(QHash<quint64, quint8> &pSrsLevels,
+                       const SrsLevels &pRecordSrsLevels);
+
+    static QVector<Record> records(const QByteArray &pData, qint64 &pSize);
+    static bool readRecord(const QByteArray &pData, const Record &pRecord,
+                           Summary &pSummary, SrsLevels &pSrsLevels);
+    static QByteArray encodedRecord(qint64 pTime, RecordKind pKind,
+                                    const Summary &pSummary,
+                                    const SrsLevels &pSrsLevels);
+
+    void setAccount(const QString &pAccount);
+    void load();
+    void compact(qint64 pTime);
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,348 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Inflater
+//==============================================================================
+
+#include "inflater.h"
+#include "metrics.h"
+
+//==============================================================================
+
+#include <QElapsedTimer>
+
+//==============================================================================
+
+#include <cstring>
+#include <memory>
+
+//==============================================================================
+
+#include "zlib.h"
+
+#ifdef USE_LIBDEFLATE
+    #include <libdeflate.h>
+#endif
+
+//==============================================================================
+
+InflaterBackend::~InflaterBackend()
+{
+}
+
+//==============================================================================
+
+QString ZlibInflaterBackend::name() const
+{
+    // Return our name
+
+    return "zlib";
+}
+
+//==============================================================================
+
+QByteArray ZlibInflaterBackend::inflated(const QByteArray &pData,
+                                         bool &pZlibNeeded) const
+{
+    // Uncompress the given data using zlib, which can handle anything
+
+    pZlibNeeded = false;
+
+    return Inflater::zlibInflated(pData);
+}
+
+//==============================================================================
+
+static const InflaterBackend & defaultBackend()
+{
+    // Return the backend we use to uncompress our data
+    // Note: this is the only place where we choose our backend, so a new
+    //       backend only needs to implement InflaterBackend and be chosen
+    //       here...
+
+#ifdef USE_LIBDEFLATE
+    static const LibdeflateInflaterBackend res;
+#else
+    static const ZlibInflaterBackend res;
+#endif
+
+    return res;
+}
+
+//==============================================================================
+
+QString Inflater::backend()
+{
+    // Return the name of the backend we use to uncompress our data
+
+    return defaultBackend().name();
+}
+
+//==============================================================================
+
+QByteArray Inflater::inflated(const QByteArray &pData)
+{
+    // Uncompress the given data using our backend
+
+    return inflated(defaultBackend(), pData);
+}
+
+//==============================================================================
+
+QByteArray Inflater::inflated(const InflaterBackend &pBackend,
+                              const QByteArray &pData)
+{
+    // Uncompress the given data using the given backend, falling back to zlib
+    // if the backend cannot handle it
+
+    QElapsedTimer inflateTimer;
+
+    inflateTimer.start();
+
+    bool zlibNeeded = false;
+    QByteArray res = pBackend.inflated(pData, zlibNeeded);
+
+    if (zlibNeeded) {
+        res = zlibStreamingInflated(pData);
+    }
+
+    Metrics::instance()->add(Metrics::InflateTime, inflateTimer.nsecsElapsed()/1000);
+
+    return res;
+}
+
+//==============================================================================
+
+quint32 Inflater::gzipInflatedSize(const QByteArray &pData)
+{
+    // Return the uncompressed size of the given data, as given by the ISIZE
+    // field of its gzip trailer, or zero if it doesn't look reasonable
+    // Note: ISIZE comes from the server, so we don't trust it to be more than a
+    //       reasonable multiple of the size of the compressed data (JSON doesn't
+    //       compress much better than that), and let our streaming path deal
+    //       with anything else...
+
+    enum {
+        GzipTrailerSize = 8,
+        MaximumCompressionRatio = 32,
+        MaximumInflatedSize = 256*1024*1024
+    };
+
+    if (pData.size() <= GzipTrailerSize) {
+        return 0;
+    }
+
+    const uchar *isize = reinterpret_cast<const uchar *>(pData.constData()+pData.size()-4);
+    quint32 res = quint32(isize[0]) | (quint32(isize[1]) << 8) | (quint32(isize[2]) << 16) | (quint32(isize[3]) << 24);
+
+    return (   (res <= MaximumInflatedSize)
+            && (qint64(res) <= qint64(MaximumCompressionRatio)*pData.size()))?res:0;
+}
+
+//==============================================================================
+
+QByteArray Inflater::zlibInflated(const QByteArray &pData)
+{
+    // Try to uncompress the given data in one go, straight into a buffer which
+    // size is given by the ISIZE field of the gzip trailer
+    // Note: this only works if the data consists of one complete gzip member,
+    //       so we check that we have uncompressed exactly what we were
+    //       expecting and nothing is left, and fall back to uncompressing the
+    //       data chunk by chunk otherwise...
+
+    quint32 inflatedSize = gzipInflatedSize(pData);
+
+    if (!inflatedSize) {
+        return zlibStreamingInflated(pData);
+    }
+
+    z_stream stream;
+
+    memset(&stream, 0, sizeof(z_stream));
+
+    if (inflateInit2_(&stream, MAX_WBITS+16, ZLIB_VERSION, sizeof(z_stream)) != Z_OK) {
+        return QByteArray();
+    }
+
+    QByteArray res = QByteArray(int(inflatedSize), Qt::Uninitialized);
+
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(pData.constData()));
+    stream.avail_in = uint(pData.size());
+    stream.next_out = reinterpret_cast<Bytef *>(res.data());
+    stream.avail_out = inflatedSize;
+
+    bool oneShot =    (inflate(&stream, Z_FINISH) == Z_STREAM_END)
+                   && !stream.avail_in && (stream.total_out == inflatedSize);
+
+    inflateEnd(&stream);
+
+    if (!oneShot) {
+        return zlibStreamingInflated(pData);
+    }
+
+    Metrics::instance()->add(Metrics::OneShotInflates);
+
+    return res;
+}
+
+//==============================================================================
+
+QByteArray Inflater::zlibStreamingInflated(const QByteArray &pData)
+{
+    // Uncompress the given data chunk by chunk
+    // Note: the data may consist of several gzip members, in which case we
+    //       reset our stream at the end of each member and carry on with the
+    //       next one...
+
+    enum {
+        BufferSize = 32768
+    };
+
+    z_stream stream;
+
+    memset(&stream, 0, sizeof(z_stream));
+
+    if (inflateInit2_(&stream, MAX_WBITS+16, ZLIB_VERSION, sizeof(z_stream)) != Z_OK) {
+        return QByteArray();
+    }
+
+    Metrics::instance()->add(Metrics::StreamingInflates);
+
+    QByteArray res = QByteArray();
+    Bytef buffer[BufferSize];
+
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(pData.constData()));
+    stream.avail_in = uint(pData.size());
+
+    forever {
+        stream.next_out = buffer;
+        stream.avail_out = BufferSize;
+
+        int status = inflate(&stream, Z_NO_FLUSH);
+
+        if ((status != Z_OK) && (status != Z_STREAM_END)) {
+            // Something went wrong (e.g. corrupt or truncated data)
+
+            res = QByteArray();
+
+            break;
+        }
+
+        const char *data = res.constData();
+
+        res += QByteArray::fromRawData(reinterpret_cast<char *>(buffer), BufferSize-int(stream.avail_out));
+
+        Metrics::instance()->add(Metrics::StreamingInflateAppends);
+
+        if (res.constData() != data) {
+            Metrics::instance()->add(Metrics::StreamingInflateReallocations);
+        }
+
+        if (status == Z_STREAM_END) {
+            if (!stream.avail_in) {
+                break;
+            }
+
+            inflateReset(&stream);
+        }
+    }
+
+    inflateEnd(&stream);
+
+    return res;
+}
+
+//==============================================================================
+
+#ifdef USE_LIBDEFLATE
+static libdeflate_decompressor * decompressor()
+{
+    // Return the decompressor of the current thread, creating it if needed
+    // Note: we may be called from several threads at once, and a decompressor
+    //       cannot be shared between threads, hence we have one per thread
+    //       rather than one per call...
+
+    static thread_local std::unique_ptr<libdeflate_decompressor, void (*)(libdeflate_decompressor *)> res(libdeflate_alloc_decompressor(),
+                                                                                                        libdeflate_free_decompressor);
+
+    return res.get();
+}
+
+//==============================================================================
+
+QString LibdeflateInflaterBackend::name() const
+{
+    // Return our name
+
+    return "libdeflate";
+}
+
+//==============================================================================
+
+QByteArray LibdeflateInflaterBackend::inflated(const QByteArray &pData,
+                                               bool &pZlibNeeded) const
+{
+    // Uncompress the given data using libdeflate
+    // Note: libdeflate can only uncompress a whole buffer, so we need the
+    //       ISIZE field of the gzip trailer to be right. If it isn't (e.g.
+    //       truncated or multi-member data) then libdeflate either doesn't have
+    //       enough space or stops after the first member, in which case we let
+    //       zlib handle our data. On the other hand, corrupt data is corrupt
+    //       data, so there is no point in letting zlib try again...
+
+    pZlibNeeded = false;
+
+    quint32 inflatedSize = Inflater::gzipInflatedSize(pData);
+    libdeflate_decompressor *libdeflateDecompressor = decompressor();
+
+    if (!inflatedSize || !libdeflateDecompressor) {
+        pZlibNeeded = true;
+
+        return QByteArray();
+    }
+
+    QByteArray res = QByteArray(int(inflatedSize), Qt::Uninitialized);
+    size_t actualDeflatedSize = 0;
+    size_t actualInflatedSize = 0;
+    libdeflate_result result = libdeflate_gzip_decompress_ex(libdeflateDecompressor,
+                                                             pData.constData(), size_t(pData.size()),
+                                                             res.data(), inflatedSize,
+                                                             &actualDeflatedSize, &actualInflatedSize);
+
+    if (   (result == LIBDEFLATE_INSUFFICIENT_SPACE)
+        || (   (result == LIBDEFLATE_SUCCESS)
+            && (actualDeflatedSize != size_t(pData.size())))) {
+        pZlibNeeded = true;
+
+        return QByteArray();
+    }
+
+    if ((result != LIBDEFLATE_SUCCESS) || (actualInflatedSize != inflatedSize)) {
+        return QByteArray();
+    }
+
+    Metrics::instance()->add(Metrics::OneShotInflates);
+
+    return res;
+}
+#endif
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,86 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Inflater
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QByteArray>
+#include <QString>
+
+//==============================================================================
+
+class InflaterBackend
+{
+public:
+    virtual ~InflaterBackend();
+
+    virtual QString name() const = 0;
+
+    virtual QByteArray inflated(const QByteArray &pData,
+                                bool &pZlibNeeded) const = 0;
+};
+
+//==============================================================================
+
+class ZlibInflaterBackend : public InflaterBackend
+{
+public:
+    QString name() const override;
+
+    QByteArray inflated(const QByteArray &pData,
+                        bool &pZlibNeeded) const override;
+};
+
+//==============================================================================
+
+#ifdef USE_LIBDEFLATE
+class LibdeflateInflaterBackend : public InflaterBackend
+{
+public:
+    QString name() const override;
+
+    QByteArray inflated(const QByteArray &pData,
+                        bool &pZlibNeeded) const override;
+};
+#endif
+
+//==============================================================================
+
+class Inflater
+{
+public:
+    static QString backend();
+
+    static QByteArray inflated(const QByteArray &pData);
+    static QByteArray inflated(const InflaterBackend &pBackend,
+                               const QByteArray &pData);
+
+    static quint32 gzipInflatedSize(const QByteArray &pData);
+
+    static QByteArray zlibInflated(const QByteArray &pData);
+    static QByteArray zlibStreamingInflated(const QByteArray &pData);
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,423 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Level up projection
+//==============================================================================
+
+#include "levelupprojection.h"
+
+//==============================================================================
+
+#include <QtConcurrentMap>
+
+//==============================================================================
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+
+static const int GuruLevel = 5;
+static const int MaxNbOfReviews = 100;
+
+static const int SrsIntervals[2][4] = { { 2, 4, 8, 23 },
+                                        { 4, 8, 23, 47 } };
+
+static const double AccuracyPriorWeight = 10.0;
+static const double ItemAccuracyPriorWeight = 4.0;
+static const double MinimumPassProbability = 0.05;
+
+//==============================================================================
+
+static inline quint32 laneSeed(quint64 pSimulation)
+{
+    // Return a (non-zero) seed for the given simulation, using the finaliser
+    // of splitmix64, so that simulations that are next to one another don't
+    // end up with related random numbers
+
+    quint64 res = pSimulation+1;
+
+    res = (res^(res >> 30))*0xbf58476d1ce4e5b9ULL;
+    res = (res^(res >> 27))*0x94d049bb133111ebULL;
+    res ^= res >> 31;
+
+    return quint32(res >> 32)|1;
+}
+
+//==============================================================================
+
+void LevelUpProjection::guruTimes(int pSrsLevel, const qint64 *pTimes,
+                                  double pPassProbability,
+                                  const int *pSrsIntervals, quint32 *pStates,
+                                  qint64 *pGuruTimes)
+{
+    // Simulate, in lockstep for all the simulations in a batch, the reviews of
+    // an item, which SRS level is given and which next review time is given
+    // for each simulation, until it reaches Guru level, and keep track of when
+    // that happens
+    // Note: each simulation has its own random number generator (xorshift32),
+    //       and a review is passed if its random number is below our pass
+    //       probability, scaled to 32 bits. A failed review brings an item
+    //       down one SRS level, although never below the first Apprentice
+    //       level. A simulation that has reached Guru level keeps drawing
+    //       random numbers, but without any effect, so that our inner loop
+    //       has no branches and can be vectorised. For the same reason, we
+    //       work on local copies of our random number generators, in hours and
+    //       with 32-bit integers, and select our SRS interval rather than look
+    //       it up...
+
+    quint32 states[BatchSize];
+    int srsLevels[BatchSize];
+    int hours[BatchSize];
+    quint32 passThreshold = (pPassProbability >= 1.0)?
+                                0xffffffffU:
+                                quint32(pPassProbability*4294967296.0);
+
+    for (int j = 0; j < BatchSize; ++j) {
+        states[j] = pStates[j];
+        srsLevels[j] = pSrsLevel?pSrsLevel:1;
+        hours[j] = pSrsLevel?0:pSrsIntervals[0];
+    }
+
+    for (int i = 0; i < MaxNbOfReviews; ++i) {
+        int inProgress = 0;
+
+        for (int j = 0; j < BatchSize; ++j) {
+            quint32 state = states[j];
+
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            states[j] = state;
+
+            int srsLevel = srsLevels[j];
+            int newSrsLevel = (state < passThreshold)?srsLevel+1:srsLevel-(srsLevel > 1);
+
+            newSrsLevel = (srsLevel < GuruLevel)?newSrsLevel:srsLevel;
+
+            hours[j] +=  (newSrsLevel == 1)*pSrsIntervals[0]
+                        +(newSrsLevel == 2)*pSrsIntervals[1]
+                        +(newSrsLevel == 3)*pSrsIntervals[2]
+                        +(newSrsLevel == 4)*pSrsIntervals[3];
+
+            srsLevels[j] = newSrsLevel;
+
+            inProgress |= newSrsLevel < GuruLevel;
+        }
+
+        if (!inProgress) {
+            break;
+        }
+    }
+
+    for (int j = 0; j < BatchSize; ++j) {
+        pStates[j] = states[j];
+        pGuruTimes[j] = pTimes[j]+3600*qint64(hours[j]);
+    }
+}
+
+//==============================================================================
+
+void LevelUpProjection::ItemStates::clear()
+{
+    // Clear our item states
+
+    srsLevels.clear();
+    availableDates.clear();
+    unlocked.clear();
+    correct.clear();
+    incorrect.clear();
+}
+
+//==============================================================================
+
+void LevelUpProjection::ItemStates::add(int pSrsLevel, uint pUnlockedDate,
+                                        uint pAvailableDate, int pCorrect,
+                                        int pIncorrect)
+{
+    // Add the state of an item
+
+    srsLevels << pSrsLevel;
+    availableDates << pAvailableDate;
+    unlocked << (pUnlockedDate != 0);
+    correct << pCorrect;
+    incorrect << pIncorrect;
+}
+
+//==============================================================================
+
+LevelUpProjection::LevelUpProjection() :
+    mUserLevel(0),
+    mRadicalsCorrect(0),
+    mRadicalsIncorrect(0),
+    mKanjisCorrect(0),
+    mKanjisIncorrect(0)
+{
+}
+
+//==============================================================================
+
+void LevelUpProjection::reset(int pUserLevel)
+{
+    // Reset ourselves for the given user level
+
+    mUserLevel = pUserLevel;
+
+    mRadicals.clear();
+    mKanjis.clear();
+
+    mRadicalsCorrect = 0;
+    mRadicalsIncorrect = 0;
+    mKanjisCorrect = 0;
+    mKanjisIncorrect = 0;
+}
+
+//==============================================================================
+
+void LevelUpProjection::add(ItemColumns::ItemType pType, int pLevel,
+                            int pSrsLevel, uint pUnlockedDate,
+                            uint pAvailableDate, int pCorrect, int pIncorrect)
+{
+    // Account for the answers given for the item and keep track of its state,
+    // if it is a radical or a Kanji from our current level
+    // Note: vocabulary plays no part in levelling up...
+
+    switch (pType) {
+    case ItemColumns::RadicalType:
+        mRadicalsCorrect += pCorrect;
+        mRadicalsIncorrect += pIncorrect;
+
+        if (pLevel == mUserLevel) {
+            mRadicals.add(pSrsLevel, pUnlockedDate, pAvailableDate, pCorrect, pIncorrect);
+        }
+
+        break;
+    case ItemColumns::KanjiType:
+        mKanjisCorrect += pCorrect;
+        mKanjisIncorrect += pIncorrect;
+
+        if (pLevel == mUserLevel) {
+            mKanjis.add(pSrsLevel, pUnlockedDate, pAvailableDate, pCorrect, pIncorrect);
+        }
+
+        break;
+    default:
+        break;
+    }
+}
+
+//==============================================================================
+
+LevelUpProjection::Eta LevelUpProjection::eta(qint64 pNowTime,
+                                               double pConfiguredAccuracy) const
+{
+    // Make sure that we have some Kanji to get to Guru level, if not then
+    // assume that we are at the start of a new level, i.e. that we have a
+    // radical and then a Kanji to get to Guru level, without any mistake (as
+    // our SRS intervals would have it)
+
+    Eta res;
+
+    if (mKanjis.srsLevels.isEmpty()) {
+        for (int i = 0; i < 4; ++i) {
+            res.likely += 2*3600*SrsIntervals[mUserLevel > 2][i];
+        }
+
+        res.optimistic = res.likely;
+        res.pessimistic = res.likely;
+
+        return res;
+    }
+
+    // Run our simulations, in batches that we spread across the global thread
+    // pool
+
+    QVector<double> radicalsPassProbabilities = passProbabilities(mRadicals, mRadicalsCorrect, mRadicalsIncorrect, pConfiguredAccuracy, 1);
+    QVector<double> kanjisPassProbabilities = passProbabilities(mKanjis, mKanjisCorrect, mKanjisIncorrect, pConfiguredAccuracy, 2);
+    QVector<Batch> batches(NbOfBatches);
+
+    for (int i = 0; i < NbOfBatches; ++i) {
+        batches[i].index = i;
+    }
+
+    QtConcurrent::blockingMap(batches, [&](Batch &pBatch) {
+        simulate(pBatch, pNowTime, radicalsPassProbabilities, kanjisPassProbabilities);
+    });
+
+    // Determine and return the 10th, 50th and 90th percentiles of the time it
+    // takes us to level up
+
+    QVector<qint64> levelUpTimes;
+
+    levelUpTimes.reserve(NbOfSimulations);
+
+    for (const auto &batch : batches) {
+        for (int i = 0; i < BatchSize; ++i) {
+            levelUpTimes << batch.levelUpTimes[i];
+        }
+    }
+
+    std::sort(levelUpTimes.begin(), levelUpTimes.end());
+
+    res.optimistic = qMax(qint64(0), levelUpTimes[int(ceil(0.1*NbOfSimulations))-1]-pNowTime);
+    res.likely = qMax(qint64(0), levelUpTimes[int(ceil(0.5*NbOfSimulations))-1]-pNowTime);
+    res.pessimistic = qMax(qint64(0), levelUpTimes[int(ceil(0.9*NbOfSimulations))-1]-pNowTime);
+    res.configuredAccuracy = !(mRadicalsCorrect+mRadicalsIncorrect) || !(mKanjisCorrect+mKanjisIncorrect);
+
+    return res;
+}
+
+//==============================================================================
+
+QVector<double> LevelUpProjection::passProbabilities(const ItemStates &pItemStates,
+                                                     qint64 pCorrect,
+                                                     qint64 pIncorrect,
+                                                     double pConfiguredAccuracy,
+                                                     int pNbOfAnswers)
+{
+    // Determine the accuracy of our answers for all our items of a given type,
+    // and then for each of the given items, biasing it towards our configured
+    // accuracy (respectively our overall accuracy) when there are only a few
+    // answers to go by
+    // Note: a review is only passed if all its answers (i.e. meaning and, for
+    //       Kanji, reading) are correct...
+
+    QVector<double> res;
+
+    res.reserve(pItemStates.srsLevels.count());
+
+    // Use our configured accuracy for all the given items if we don't have any
+    // answers to go by (e.g. the user's review statistics are not available)
+
+    if (!(pCorrect+pIncorrect)) {
+        res.fill(qBound(MinimumPassProbability, pow(pConfiguredAccuracy, pNbOfAnswers), 1.0),
+                 pItemStates.srsLevels.count());
+
+        return res;
+    }
+
+    double accuracy = (pCorrect+AccuracyPriorWeight*pConfiguredAccuracy)/(pCorrect+pIncorrect+AccuracyPriorWeight);
+
+    for (int i = 0, iMax = pItemStates.srsLevels.count(); i < iMax; ++i) {
+        double itemAccuracy = (pItemStates.correct[i]+ItemAccuracyPriorWeight*accuracy)/(pItemStates.correct[i]+pItemStates.incorrect[i]+ItemAccuracyPriorWeight);
+
+        res << qBound(MinimumPassProbability, pow(itemAccuracy, pNbOfAnswers), 1.0);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+void LevelUpProjection::simulate(Batch &pBatch, qint64 pNowTime,
+                                 const QVector<double> &pRadicalsPassProbabilities,
+                                 const QVector<double> &pKanjisPassProbabilities) const
+{
+    // Seed the random number generator of each simulation in our batch
+    // Note: a simulation is seeded from its overall index, so that our
+    //       projection doesn't change from one call to another unless our
+    //       items or the time do...
+
+    const int *srsIntervals = SrsIntervals[mUserLevel > 2];
+    quint32 states[BatchSize];
+
+    for (int j = 0; j < BatchSize; ++j) {
+        states[j] = laneSeed(quint64(pBatch.index)*BatchSize+j);
+    }
+
+    // Determine, for each simulation in our batch, when all the radicals from
+    // our current level get to Guru level
+    // Note: a review that is already available is assumed to be done now...
+
+    qint64 radicalsGuruTimes[BatchSize];
+    qint64 times[BatchSize];
+    qint64 itemGuruTimes[BatchSize];
+
+    std::fill(radicalsGuruTimes, radicalsGuruTimes+BatchSize, pNowTime);
+
+    for (int i = 0, iMax = mRadicals.srsLevels.count(); i < iMax; ++i) {
+        int srsLevel = mRadicals.srsLevels[i];
+
+        if (srsLevel >= GuruLevel) {
+            continue;
+        }
+
+        std::fill(times, times+BatchSize, qMax(mRadicals.availableDates[i], pNowTime));
+
+        guruTimes(srsLevel, times, pRadicalsPassProbabilities[i],
+                  srsIntervals, states, itemGuruTimes);
+
+        for (int j = 0; j < BatchSize; ++j) {
+            radicalsGuruTimes[j] = qMax(radicalsGuruTimes[j], itemGuruTimes[j]);
+        }
+    }
+
+    // Determine, for each simulation in our batch, when each of the Kanji from
+    // our current level gets to Guru level
+    // Note: we don't know which radicals a locked Kanji is made of, so we
+    //       assume that it gets unlocked once all the radicals from our
+    //       current level have got to Guru level...
+
+    int nbOfKanjis = mKanjis.srsLevels.count();
+    QVector<qint64> kanjisGuruTimes(BatchSize*nbOfKanjis);
+
+    for (int i = 0; i < nbOfKanjis; ++i) {
+        int srsLevel = mKanjis.srsLevels[i];
+
+        if (srsLevel >= GuruLevel) {
+            for (int j = 0; j < BatchSize; ++j) {
+                kanjisGuruTimes[j*nbOfKanjis+i] = pNowTime;
+            }
+
+            continue;
+        }
+
+        if (mKanjis.unlocked[i]) {
+            std::fill(times, times+BatchSize, qMax(mKanjis.availableDates[i], pNowTime));
+
+            guruTimes(srsLevel, times, pKanjisPassProbabilities[i],
+                      srsIntervals, states, itemGuruTimes);
+        } else {
+            guruTimes(0, radicalsGuruTimes, pKanjisPassProbabilities[i],
+                      srsIntervals, states, itemGuruTimes);
+        }
+
+        for (int j = 0; j < BatchSize; ++j) {
+            kanjisGuruTimes[j*nbOfKanjis+i] = itemGuruTimes[j];
+        }
+    }
+
+    // Determine, for each simulation in our batch, when we level up, i.e. when
+    // 90% of the Kanji from our current level have got to Guru level
+
+    int nbOfGuruKanjis = int(ceil(0.9*nbOfKanjis));
+
+    for (int j = 0; j < BatchSize; ++j) {
+        auto begin = kanjisGuruTimes.begin()+j*nbOfKanjis;
+
+        std::nth_element(begin, begin+nbOfGuruKanjis-1, begin+nbOfKanjis);
+
+        pBatch.levelUpTimes[j] = *(begin+nbOfGuruKanjis-1);
+    }
+}
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,108 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Level up projection
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "wanikani.h"
+
+//==============================================================================
+
+#include <QVector>
+
+//==============================================================================
+
+class LevelUpProjection
+{
+public:
+    struct Eta
+    {
+        qint64 optimistic = 0;
+        qint64 likely = 0;
+        qint64 pessimistic = 0;
+        bool configuredAccuracy = false;
+    };
+
+    explicit LevelUpProjection();
+
+    void reset(int pUserLevel);
+
+    void add(ItemColumns::ItemType pType, int pLevel, int pSrsLevel,
+             uint pUnlockedDate, uint pAvailableDate, int pCorrect,
+             int pIncorrect);
+
+    Eta eta(qint64 pNowTime, double pConfiguredAccuracy) const;
+
+private:
+    enum {
+        NbOfSimulations = 1024,
+        BatchSize = 64,
+        NbOfBatches = NbOfSimulations/BatchSize
+    };
+
+    struct ItemStates
+    {
+        QVector<int> srsLevels;
+        QVector<qint64> availableDates;
+        QVector<bool> unlocked;
+        QVector<int> correct;
+        QVector<int> incorrect;
+
+        void clear();
+        void add(int pSrsLevel, uint pUnlockedDate, uint pAvailableDate,
+                 int pCorrect, int pIncorrect);
+    };
+
+    struct Batch
+    {
+        int index;
+        qint64 levelUpTimes[BatchSize];
+    };
+
+    int mUserLevel;
+
+    ItemStates mRadicals;
+    ItemStates mKanjis;
+
+    qint64 mRadicalsCorrect;
+    qint64 mRadicalsIncorrect;
+    qint64 mKanjisCorrect;
+    qint64 mKanjisIncorrect;
+
+    static QVector<double> passProbabilities(const ItemStates &pItemStates,
+                                             qint64 pCorrect, qint64 pIncorrect,
+                                             double pConfiguredAccuracy,
+                                             int pNbOfAnswers);
+
+    static void guruTimes(int pSrsLevel, const qint64 *pTimes,
+                          double pPassProbability, const int *pSrsIntervals,
+                          quint32 *pStates, qint64 *pGuruTimes);
+
+    void simulate(Batch &pBatch, qint64 pNowTime,
+                  const QVector<double> &pRadicalsPassProbabilities,
+                  const QVector<double> &pKanjisPassProbabilities) const;
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
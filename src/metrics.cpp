@@ -0,0 +1,721 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Metrics
+//==============================================================================
+
+#include "metrics.h"
+
+//==============================================================================
+
+#include <QFile>
+
+//==============================================================================
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+
+#if defined(Q_OS_WIN)
+    #include <Windows.h>
+    #include <Psapi.h>
+#elif defined(Q_OS_MAC)
+    #include <malloc/malloc.h>
+    #include <mach/mach.h>
+#else
+    #include <malloc.h>
+    #include <unistd.h>
+#endif
+
+//==============================================================================
+
+Metrics::Metrics()
+{
+    // Reset all of our counters
+
+    for (auto &endpoint : mEndpoints) {
+        endpoint.compressedSize = 0;
+        endpoint.inflatedSize = 0;
+        endpoint.nbOfFetches = 0;
+        endpoint.lastFetchLatency = 0;
+        endpoint.totalFetchLatency = 0;
+
+        for (auto &fetchLatency : endpoint.fetchLatencies) {
+            fetchLatency = 0;
+        }
+
+        endpoint.lastHandshakeTime = 0;
+        endpoint.lastTransferTime = 0;
+
+        endpoint.parseTime = 0;
+        endpoint.newParseTime = 0;
+        endpoint.parsing = false;
+
+        endpoint.nbOfItems = 0;
+    }
+
+    for (auto &host : mHosts) {
+        host.nbOfHandshakes = 0;
+        host.nbOfResumedHandshakes = 0;
+    }
+
+    for (auto &counter : mCounters) {
+        counter = 0;
+    }
+}
+
+//==============================================================================
+
+Metrics * Metrics::instance()
+{
+    // Return our (single) instance
+
+    static Metrics instance;
+
+    return &instance;
+}
+
+//==============================================================================
+
+QString Metrics::endpointName(Endpoint pEndpoint)
+{
+    // Return the name of the given endpoint
+
+    switch (pEndpoint) {
+    case UserEndpoint:
+        return "user";
+    case StudyQueueEndpoint:
+        return "study-queue";
+    case LevelProgressionEndpoint:
+        return "level-progression";
+    case SrsDistributionEndpoint:
+        return "srs-distribution";
+    case RadicalsEndpoint:
+        return "radicals";
+    case KanjiEndpoint:
+        return "kanji";
+    case VocabularyEndpoint:
+        return "vocabulary";
+    case SubjectsEndpoint:
+        return "subjects";
+    case AssignmentsEndpoint:
+        return "assignments";
+    case ReviewStatisticsEndpoint:
+        return "review-statistics";
+    default:
+        return QString();
+    }
+}
+
+//==============================================================================
+
+QString Metrics::hostName(Host pHost)
+{
+    // Return the name of the given host
+
+    switch (pHost) {
+    case V1Host:
+        return "www.wanikani.com";
+    case V2Host:
+        return "api.wanikani.com";
+    default:
+        return QString();
+    }
+}
+
+//==============================================================================
+
+QString Metrics::counterName(Counter pCounter)
+{
+    // Return the name of the given counter
+
+    switch (pCounter) {
+    case WallpaperRenderTime:
+        return "wallpaper_render_time_us";
+    case WallpaperEncodeTime:
+        return "wallpaper_encode_time_us";
+    case WallpaperRewrites:
+        return "wallpaper_rewrites_total";
+    case GsettingsSpawns:
+        return "gsettings_spawns_total";
+    case Http2Replies:
+        return "http2_replies_total";
+    case UpdatesJoined:
+        return "updates_joined_total";
+    case UpdatesCancelled:
+        return "updates_cancelled_total";
+    case EndpointsSkipped:
+        return "endpoints_skipped_total";
+    case DerivationMismatches:
+        return "derivation_mismatches_total";
+    case ResponsesUnchanged:
+        return "responses_unchanged_total";
+    case OneShotInflates:
+        return "one_shot_inflates_total";
+    case StreamingInflates:
+        return "streaming_inflates_total";
+    case StreamingInflateAppends:
+        return "streaming_inflate_appends_total";
+    case StreamingInflateReallocations:
+        return "streaming_inflate_reallocations_total";
+    case InflateTime:
+        return "inflate_time_us_total";
+    case V2QueueDepth:
+        return "v2_queue_depth";
+    case V2QueueWaitTime:
+        return "v2_queue_wait_last_ms";
+    case V2RequestsThrottled:
+        return "v2_requests_throttled_total";
+    case V2RequestsRateLimited:
+        return "v2_requests_rate_limited_total";
+    case HeapSizeAfterUpdate:
+        return "heap_after_update_bytes";
+    case ResidentSetSizeAfterUpdate:
+        return "resident_set_after_update_bytes";
+    case NextUpdateDelay:
+        return "next_update_delay_seconds";
+    case AggregationTime:
+        return "aggregation_time_us";
+    case LevelUpProjectionTime:
+        return "level_up_projection_time_us";
+    case LevelUpProjectionsOverFrameBudget:
+        return "level_up_projections_over_frame_budget_total";
+    case WorkloadForecastTime:
+        return "workload_forecast_time_us";
+    case HistoryAppendTime:
+        return "history_append_time_us";
+    case HistoryCompactions:
+        return "history_compactions_total";
+    case SnapshotDiffTime:
+        return "snapshot_diff_time_us";
+    case ChangedItems:
+        return "changed_items";
+    default:
+        return QString();
+    }
+}
+
+//==============================================================================
+
+QString Metrics::counterDescription(Counter pCounter)
+{
+    // Return a description of the given counter
+
+    switch (pCounter) {
+    case WallpaperRenderTime:
+        return "Time it took to render our last wallpaper, in microseconds.";
+    case WallpaperEncodeTime:
+        return "Time it took to encode our last wallpaper, in microseconds.";
+    case WallpaperRewrites:
+        return "Number of times that our wallpaper was written to disk.";
+    case GsettingsSpawns:
+        return "Number of times that gsettings was spawned.";
+    case Http2Replies:
+        return "Number of replies received over HTTP/2.";
+    case UpdatesJoined:
+        return "Number of updates that joined an in-flight update.";
+    case UpdatesCancelled:
+        return "Number of updates that were cancelled.";
+    case EndpointsSkipped:
+        return "Number of endpoints that were not requested since they were still fresh.";
+    case DerivationMismatches:
+        return "Number of times that our derived information differed from the one we retrieved.";
+    case ResponsesUnchanged:
+        return "Number of responses that were identical to the previous ones.";
+    case OneShotInflates:
+        return "Number of responses that were inflated in one go.";
+    case StreamingInflates:
+        return "Number of responses that were inflated in a streaming way.";
+    case StreamingInflateAppends:
+        return "Number of chunks that were appended while inflating in a streaming way.";
+    case StreamingInflateReallocations:
+        return "Number of reallocations while inflating in a streaming way.";
+    case InflateTime:
+        return "Total time spent inflating responses, in microseconds.";
+    case V2QueueDepth:
+        return "Number of v2 requests waiting to be sent.";
+    case V2QueueWaitTime:
+        return "Time our last v2 request waited before being sent, in milliseconds.";
+    case V2RequestsThrottled:
+        return "Number of v2 requests that were held back to stay within the v2 rate limit.";
+    case V2RequestsRateLimited:
+        return "Number of v2 requests that were rate limited by WaniKani.";
+    case HeapSizeAfterUpdate:
+        return "Number of bytes allocated on our heap after our last update.";
+    case ResidentSetSizeAfterUpdate:
+        return "Resident set size after our last update, in bytes.";
+    case NextUpdateDelay:
+        return "Delay before our next update, in seconds.";
+    case AggregationTime:
+        return "Time it took to aggregate our items, in microseconds.";
+    case LevelUpProjectionTime:
+        return "Time it took to project when we will level up, in microseconds.";
+    case LevelUpProjectionsOverFrameBudget:
+        return "Number of level up projections that took longer than a frame (16 ms) on our GUI thread.";
+    case WorkloadForecastTime:
+        return "Time it took to forecast our workload, in microseconds.";
+    case HistoryAppendTime:
+        return "Time it took to append our last snapshot to our history, in microseconds.";
+    case HistoryCompactions:
+        return "Number of times that our history was compacted.";
+    case SnapshotDiffTime:
+        return "Time it took to compare our last two snapshots, in microseconds.";
+    case ChangedItems:
+        return "Number of items that changed between our last two snapshots.";
+    default:
+        return QString();
+    }
+}
+
+//==============================================================================
+
+void Metrics::addDownload(Endpoint pEndpoint, qint64 pCompressedSize,
+                          qint64 pInflatedSize)
+{
+    // Account for the given download
+
+    mEndpoints[pEndpoint].compressedSize += pCompressedSize;
+    mEndpoints[pEndpoint].inflatedSize += pInflatedSize;
+}
+
+//==============================================================================
+
+void Metrics::addFetchLatency(Endpoint pEndpoint, qint64 pLatency)
+{
+    // Account for the given fetch latency, keeping track of our most recent
+    // ones so that we can compute our 95th percentile
+
+    EndpointMetrics &endpoint = mEndpoints[pEndpoint];
+    qint64 nbOfFetches = endpoint.nbOfFetches.fetch_add(1);
+
+    endpoint.lastFetchLatency = pLatency;
+    endpoint.totalFetchLatency += pLatency;
+    endpoint.fetchLatencies[nbOfFetches % NbOfLatencySamples] = pLatency;
+}
+
+//==============================================================================
+
+void Metrics::setHandshakeAndTransferTimes(Endpoint pEndpoint,
+                                           qint64 pHandshakeTime,
+                                           qint64 pTransferTime)
+{
+    // Set the (last) handshake and transfer times of the given endpoint
+
+    mEndpoints[pEndpoint].lastHandshakeTime = pHandshakeTime;
+    mEndpoints[pEndpoint].lastTransferTime = pTransferTime;
+}
+
+//==============================================================================
+
+void Metrics::resetParseTime(Endpoint pEndpoint)
+{
+    // Reset the time it takes to parse the given endpoint, which we have just
+    // requested
+    // Note: our parse time is only published once our update is done (see
+    //       publishParseTimes()), so that it never reflects a partial update,
+    //       e.g. only some of the pages of a v2 collection...
+
+    mEndpoints[pEndpoint].newParseTime = 0;
+    mEndpoints[pEndpoint].parsing = false;
+}
+
+//==============================================================================
+
+void Metrics::addParseTime(Endpoint pEndpoint, qint64 pParseTime)
+{
+    // Add to the time it takes to parse the given endpoint, i.e. to parse its
+    // JSON responses and to decode them
+
+    mEndpoints[pEndpoint].newParseTime += pParseTime;
+    mEndpoints[pEndpoint].parsing = true;
+}
+
+//==============================================================================
+
+void Metrics::publishParseTimes()
+{
+    // Publish the parse time of the endpoints that we parsed during our update,
+    // leaving the other ones (e.g. those that were fresh or unchanged) as they
+    // were
+
+    for (auto &endpoint : mEndpoints) {
+        if (endpoint.parsing.exchange(false)) {
+            endpoint.parseTime = endpoint.newParseTime.load();
+        }
+    }
+}
+
+//==============================================================================
+
+void Metrics::setNbOfItems(Endpoint pEndpoint, int pNbOfItems)
+{
+    // Set the number of items of the given endpoint
+
+    mEndpoints[pEndpoint].nbOfItems = pNbOfItems;
+}
+
+//==============================================================================
+
+qint64 Metrics::compressedSize(Endpoint pEndpoint) const
+{
+    // Return the number of compressed bytes downloaded for the given endpoint
+
+    return mEndpoints[pEndpoint].compressedSize;
+}
+
+//==============================================================================
+
+qint64 Metrics::inflatedSize(Endpoint pEndpoint) const
+{
+    // Return the number of inflated bytes downloaded for the given endpoint
+
+    return mEndpoints[pEndpoint].inflatedSize;
+}
+
+//==============================================================================
+
+qint64 Metrics::nbOfFetches(Endpoint pEndpoint) const
+{
+    // Return the number of fetches for the given endpoint
+
+    return mEndpoints[pEndpoint].nbOfFetches;
+}
+
+//==============================================================================
+
+qint64 Metrics::lastFetchLatency(Endpoint pEndpoint) const
+{
+    // Return the last fetch latency for the given endpoint
+
+    return mEndpoints[pEndpoint].lastFetchLatency;
+}
+
+//==============================================================================
+
+qint64 Metrics::averageFetchLatency(Endpoint pEndpoint) const
+{
+    // Return the average fetch latency for the given endpoint
+
+    qint64 nbOfFetches = mEndpoints[pEndpoint].nbOfFetches;
+
+    return nbOfFetches?mEndpoints[pEndpoint].totalFetchLatency/nbOfFetches:0;
+}
+
+//==============================================================================
+
+qint64 Metrics::p95FetchLatency(Endpoint pEndpoint) const
+{
+    // Return the 95th percentile of our most recent fetch latencies for the
+    // given endpoint
+
+    int nbOfSamples = int(qMin(mEndpoints[pEndpoint].nbOfFetches.load(), qint64(NbOfLatencySamples)));
+
+    if (!nbOfSamples) {
+        return 0;
+    }
+
+    qint64 fetchLatencies[NbOfLatencySamples];
+
+    for (int i = 0; i < nbOfSamples; ++i) {
+        fetchLatencies[i] = mEndpoints[pEndpoint].fetchLatencies[i];
+    }
+
+    std::sort(fetchLatencies, fetchLatencies+nbOfSamples);
+
+    return fetchLatencies[int(ceil(0.95*nbOfSamples))-1];
+}
+
+//==============================================================================
+
+qint64 Metrics::lastHandshakeTime(Endpoint pEndpoint) const
+{
+    // Return the last handshake time for the given endpoint
+
+    return mEndpoints[pEndpoint].lastHandshakeTime;
+}
+
+//==============================================================================
+
+qint64 Metrics::lastTransferTime(Endpoint pEndpoint) const
+{
+    // Return the last transfer time for the given endpoint
+
+    return mEndpoints[pEndpoint].lastTransferTime;
+}
+
+//==============================================================================
+
+qint64 Metrics::parseTime(Endpoint pEndpoint) const
+{
+    // Return the time it took to parse the given endpoint the last time that
+    // we parsed it
+
+    return mEndpoints[pEndpoint].parseTime;
+}
+
+//==============================================================================
+
+int Metrics::nbOfItems(Endpoint pEndpoint) const
+{
+    // Return the number of items for the given endpoint
+
+    return mEndpoints[pEndpoint].nbOfItems;
+}
+
+//==============================================================================
+
+void Metrics::addHandshake(Host pHost, bool pResumed)
+{
+    // Account for a (resumed) TLS handshake with the given host
+
+    ++mHosts[pHost].nbOfHandshakes;
+
+    if (pResumed) {
+        ++mHosts[pHost].nbOfResumedHandshakes;
+    }
+}
+
+//==============================================================================
+
+qint64 Metrics::nbOfHandshakes(Host pHost) const
+{
+    // Return the number of TLS handshakes with the given host
+
+    return mHosts[pHost].nbOfHandshakes;
+}
+
+//==============================================================================
+
+qint64 Metrics::nbOfResumedHandshakes(Host pHost) const
+{
+    // Return the number of resumed TLS handshakes with the given host
+
+    return mHosts[pHost].nbOfResumedHandshakes;
+}
+
+//==============================================================================
+
+double Metrics::resumptionRate(Host pHost) const
+{
+    // Return the rate at which our TLS handshakes with the given host resumed a
+    // session rather than doing a full handshake
+
+    qint64 nbOfHandshakes = mHosts[pHost].nbOfHandshakes;
+
+    return nbOfHandshakes?double(mHosts[pHost].nbOfResumedHandshakes)/nbOfHandshakes:0.0;
+}
+
+//==============================================================================
+
+void Metrics::add(Counter pCounter, qint64 pValue)
+{
+    // Add the given value to the given counter
+
+    mCounters[pCounter] += pValue;
+}
+
+//==============================================================================
+
+void Metrics::set(Counter pCounter, qint64 pValue)
+{
+    // Set the given counter to the given value
+
+    mCounters[pCounter] = pValue;
+}
+
+//==============================================================================
+
+qint64 Metrics::value(Counter pCounter) const
+{
+    // Return the value of the given counter
+
+    return mCounters[pCounter];
+}
+
+//==============================================================================
+
+qint64 Metrics::heapSize()
+{
+    // Return the number of bytes currently allocated on our heap, if possible
+
+#if defined(Q_OS_WIN)
+    return -1;
+#elif defined(Q_OS_MAC)
+    malloc_statistics_t statistics;
+
+    malloc_zone_statistics(nullptr, &statistics);
+
+    return qint64(statistics.size_in_use);
+#elif defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+    return qint64(mallinfo2().uordblks);
+#elif defined(__GLIBC__)
+    return qint64(uint(mallinfo().uordblks));
+#else
+    return -1;
+#endif
+}
+
+//==============================================================================
+
+qint64 Metrics::residentSetSize()
+{
+    // Return our resident set size, if possible
+
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS processMemoryCounters;
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &processMemoryCounters,
+                             sizeof(processMemoryCounters))) {
+        return qint64(processMemoryCounters.WorkingSetSize);
+    }
+
+    return -1;
+#elif defined(Q_OS_MAC)
+    mach_task_basic_info_data_t taskBasicInfo;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  task_info_t(&taskBasicInfo), &count) == KERN_SUCCESS) {
+        return qint64(taskBasicInfo.resident_size);
+    }
+
+    return -1;
+#else
+    QFile statmFile("/proc/self/statm");
+
+    if (!statmFile.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    QList<QByteArray> statm = statmFile.readAll().split(' ');
+
+    if (statm.count() < 2) {
+        return -1;
+    }
+
+    return statm[1].toLongLong()*sysconf(_SC_PAGESIZE);
+#endif
+}
+
+//==============================================================================
+
+void Metrics::trimHeap()
+{
+    // Return, if possible, the free memory at the top of our heap to the
+    // system, so that our resident set size actually drops once we have
+    // released some (big) data
+
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+//==============================================================================
+
+QByteArray Metrics::prometheusText() const
+{
+    // Return our metrics using the Prometheus text format
+    // Note: the samples of a metric must all follow its HELP and TYPE lines,
+    //       hence we go through our endpoints for each of our endpoint
+    //       metrics. Also, a metric is a counter if its name ends with
+    //       "_total" and a gauge otherwise...
+
+    static const QString Help = "# HELP wanikani_%1 %2\n";
+    static const QString Type = "# TYPE wanikani_%1 %2\n";
+    static const QString EndpointMetric = "wanikani_%1{endpoint=\"%2\"} %3\n";
+    static const QString HostMetric = "wanikani_%1{host=\"%2\"} %3\n";
+    static const QString Metric = "wanikani_%1 %2\n";
+
+    QString res = QString();
+
+    auto addMetricHeader = [&](const QString &pName, const QString &pDescription) {
+        res += Help.arg(pName, pDescription);
+        res += Type.arg(pName, pName.endsWith("_total")?"counter":"gauge");
+    };
+    auto addEndpointMetric = [&](const QString &pName, const QString &pDescription,
+                                 qint64 (Metrics::*pValue)(Endpoint) const) {
+        addMetricHeader(pName, pDescription);
+
+        for (int i = 0; i < NbOfEndpoints; ++i) {
+            Endpoint endpoint = Endpoint(i);
+
+            res += EndpointMetric.arg(pName, endpointName(endpoint)).arg((this->*pValue)(endpoint));
+        }
+    };
+
+    addEndpointMetric("compressed_bytes_total", "Number of compressed bytes downloaded.", &Metrics::compressedSize);
+    addEndpointMetric("inflated_bytes_total", "Number of bytes downloaded, once inflated.", &Metrics::inflatedSize);
+    addEndpointMetric("fetches_total", "Number of fetches.", &Metrics::nbOfFetches);
+    addEndpointMetric("fetch_latency_last_ms", "Latency of the last fetch, in milliseconds.", &Metrics::lastFetchLatency);
+    addEndpointMetric("fetch_latency_avg_ms", "Average fetch latency, in milliseconds.", &Metrics::averageFetchLatency);
+    addEndpointMetric("fetch_latency_p95_ms", "95th percentile of the recent fetch latencies, in milliseconds.", &Metrics::p95FetchLatency);
+    addEndpointMetric("handshake_time_last_ms", "Handshake time of the last fetch, in milliseconds.", &Metrics::lastHandshakeTime);
+    addEndpointMetric("transfer_time_last_ms", "Transfer time of the last fetch, in milliseconds.", &Metrics::lastTransferTime);
+    addEndpointMetric("parse_time_us", "Time it took to parse and decode the responses of the last update, in microseconds.", &Metrics::parseTime);
+
+    addMetricHeader("items", "Number of items.");
+
+    for (int i = 0; i < NbOfEndpoints; ++i) {
+        Endpoint endpoint = Endpoint(i);
+
+        res += EndpointMetric.arg("items", endpointName(endpoint)).arg(nbOfItems(endpoint));
+    }
+
+    addMetricHeader("tls_handshakes_total", "Number of TLS handshakes.");
+
+    for (int i = 0; i < NbOfHosts; ++i) {
+        res += HostMetric.arg("tls_handshakes_total", hostName(Host(i))).arg(nbOfHandshakes(Host(i)));
+    }
+
+    addMetricHeader("tls_resumed_handshakes_total", "Number of TLS handshakes that resumed a session.");
+
+    for (int i = 0; i < NbOfHosts; ++i) {
+        res += HostMetric.arg("tls_resumed_handshakes_total", hostName(Host(i))).arg(nbOfResumedHandshakes(Host(i)));
+    }
+
+    addMetricHeader("tls_resumption_ratio", "Ratio of TLS handshakes that resumed a session.");
+
+    for (int i = 0; i < NbOfHosts; ++i) {
+        res += HostMetric.arg("tls_resumption_ratio", hostName(Host(i))).arg(resumptionRate(Host(i)));
+    }
+
+    for (int i = 0; i < NbOfCounters; ++i) {
+        Counter counter = Counter(i);
+        QString name = counterName(counter);
+
+        addMetricHeader(name, counterDescription(counter));
+
+        res += Metric.arg(name).arg(value(counter));
+    }
+
+    addMetricHeader("heap_bytes", "Number of bytes currently allocated on our heap.");
+
+    res += Metric.arg("heap_bytes").arg(heapSize());
+
+    addMetricHeader("resident_set_bytes", "Current resident set size, in bytes.");
+
+    res += Metric.arg("resident_set_bytes").arg(residentSetSize());
+
+    return res.toUtf8();
+}
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,173 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Metrics
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QString>
+
+//==============================================================================
+
+#include <atomic>
+
+//==============================================================================
+
+class Metrics
+{
+public:
+    enum Endpoint {
+        UserEndpoint,
+        StudyQueueEndpoint,
+        LevelProgressionEndpoint,
+        SrsDistributionEndpoint,
+        RadicalsEndpoint,
+        KanjiEndpoint,
+        VocabularyEndpoint,
+        SubjectsEndpoint,
+        AssignmentsEndpoint,
+        ReviewStatisticsEndpoint,
+        NbOfEndpoints
+    };
+
+    enum Host {
+        V1Host,
+        V2Host,
+        NbOfHosts
+    };
+
+    enum Counter {
+        WallpaperRenderTime,
+        WallpaperEncodeTime,
+        WallpaperRewrites,
+        GsettingsSpawns,
+        Http2Replies,
+        UpdatesJoined,
+        UpdatesCancelled,
+        EndpointsSkipped,
+        DerivationMismatches,
+        ResponsesUnchanged,
+        OneShotInflates,
+        StreamingInflates,
+        StreamingInflateAppends,
+        StreamingInflateReallocations,
+        InflateTime,
+        V2QueueDepth,
+        V2QueueWaitTime,
+        V2RequestsThrottled,
+        V2RequestsRateLimited,
+        HeapSizeAfterUpdate,
+        ResidentSetSizeAfterUpdate,
+        NextUpdateDelay,
+        AggregationTime,
+        LevelUpProjectionTime,
+        LevelUpProjectionsOverFrameBudget,
+        WorkloadForecastTime,
+        HistoryAppendTime,
+        HistoryCompactions,
+        SnapshotDiffTime,
+        ChangedItems,
+        NbOfCounters
+    };
+
+    static Metrics * instance();
+
+    static QString endpointName(Endpoint pEndpoint);
+    static QString hostName(Host pHost);
+    static QString counterName(Counter pCounter);
+    static QString counterDescription(Counter pCounter);
+
+    void addDownload(Endpoint pEndpoint, qint64 pCompressedSize,
+                     qint64 pInflatedSize);
+    void addFetchLatency(Endpoint pEndpoint, qint64 pLatency);
+    void setHandshakeAndTransferTimes(Endpoint pEndpoint, qint64 pHandshakeTime,
+                                      qint64 pTransferTime);
+    void resetParseTime(Endpoint pEndpoint);
+    void addParseTime(Endpoint pEndpoint, qint64 pParseTime);
+    void publishParseTimes();
+    void setNbOfItems(Endpoint pEndpoint, int pNbOfItems);
+
+    qint64 compressedSize(Endpoint pEndpoint) const;
+    qint64 inflatedSize(Endpoint pEndpoint) const;
+    qint64 nbOfFetches(Endpoint pEndpoint) const;
+    qint64 lastFetchLatency(Endpoint pEndpoint) const;
+    qint64 averageFetchLatency(Endpoint pEndpoint) const;
+    qint64 p95FetchLatency(Endpoint pEndpoint) const;
+    qint64 lastHandshakeTime(Endpoint pEndpoint) const;
+    qint64 lastTransferTime(Endpoint pEndpoint) const;
+    qint64 parseTime(Endpoint pEndpoint) const;
+    int nbOfItems(Endpoint pEndpoint) const;
+
+    void addHandshake(Host pHost, bool pResumed);
+
+    qint64 nbOfHandshakes(Host pHost) const;
+    qint64 nbOfResumedHandshakes(Host pHost) const;
+    double resumptionRate(Host pHost) const;
+
+    void add(Counter pCounter, qint64 pValue = 1);
+    void set(Counter pCounter, qint64 pValue);
+    qint64 value(Counter pCounter) const;
+
+    static qint64 heapSize();
+    static qint64 residentSetSize();
+
+    static void trimHeap();
+
+    QByteArray prometheusText() const;
+
+private:
+    enum {
+        NbOfLatencySamples = 64
+    };
+
+    struct EndpointMetrics
+    {
+        std::atomic<qint64> compressedSize;
+        std::atomic<qint64> inflatedSize;
+        std::atomic<qint64> nbOfFetches;
+        std::atomic<qint64> lastFetchLatency;
+        std::atomic<qint64> totalFetchLatency;
+        std::atomic<qint64> fetchLatencies[NbOfLatencySamples];
+        std::atomic<qint64> lastHandshakeTime;
+        std::atomic<qint64> lastTransferTime;
+        std::atomic<qint64> parseTime;
+        std::atomic<qint64> newParseTime;
+        std::atomic<bool> parsing;
+        std::atomic<int> nbOfItems;
+    };
+
+    struct HostMetrics
+    {
+        std::atomic<qint64> nbOfHandshakes;
+        std::atomic<qint64> nbOfResumedHandshakes;
+    };
+
+    EndpointMetrics mEndpoints[NbOfEndpoints];
+    HostMetrics mHosts[NbOfHosts];
+    std::atomic<qint64> mCounters[NbOfCounters];
+
+    explicit Metrics();
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
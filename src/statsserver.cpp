@@ -0,0 +1,238 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Stats server
+//==============================================================================
+
+#include "metrics.h"
+#include "statsserver.h"
+
+//==============================================================================
+
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStandardPaths>
+#include <QTimer>
+
+//==============================================================================
+
+static const int ReadTimeout = 5000;
+static const qint64 MaximumRequestLineSize = 8192;
+
+//==============================================================================
+
+StatsServerWorker::StatsServerWorker(const StatsServer *pStatsServer) :
+    mStatsServer(pStatsServer),
+    mLocalServer(nullptr)
+{
+}
+
+//==============================================================================
+
+void StatsServerWorker::listen()
+{
+    // Create our local server and start listening for connections
+    // Note: we are the only instance of our application (see main()), so any
+    //       existing server of ours can only be a stale one, hence we remove
+    //       it and try again if we cannot listen...
+
+    mLocalServer = new QLocalServer(this);
+
+    mLocalServer->setSocketOptions(QLocalServer::UserAccessOption);
+
+    QString serverName = StatsServer::serverName();
+
+    if (   !mLocalServer->listen(serverName)
+        && (   !QLocalServer::removeServer(serverName)
+            || !mLocalServer->listen(serverName))) {
+        qWarning("Could not listen on %s: %s",
+                 qPrintable(serverName),
+                 qPrintable(mLocalServer->errorString()));
+
+        return;
+    }
+
+    connect(mLocalServer, &QLocalServer::newConnection,
+            this, &StatsServerWorker::newConnection);
+}
+
+//==============================================================================
+
+void StatsServerWorker::newConnection()
+{
+    // Handle all our pending connections
+
+    // Note: a client that doesn't send us its request line in time gets
+    //       disconnected...
+
+    while (QLocalSocket *socket = mLocalServer->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected,
+                socket, &QLocalSocket::deleteLater);
+        connect(socket, &QLocalSocket::readyRead,
+                this, &StatsServerWorker::readyRead);
+
+        QTimer::singleShot(ReadTimeout, socket, &QLocalSocket::abort);
+    }
+}
+
+//==============================================================================
+
+void StatsServerWorker::readyRead()
+{
+    // Wait for the request line of our client
+
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+
+    if (!socket->canReadLine()) {
+        // Make sure that our client doesn't send us an overly long request
+        // line
+
+        if (socket->bytesAvailable() > MaximumRequestLineSize) {
+            socket->abort();
+        }
+
+        return;
+    }
+
+    // Serve our client, using either our (immutable) snapshot or our metrics,
+    // and then close the connection
+
+    static const QString Response = "HTTP/1.0 %1\r\n"
+                                    "Content-Type: %2\r\n"
+                                    "Content-Length: %3\r\n"
+                                    "Connection: close\r\n"
+                                    "\r\n";
+
+    QList<QByteArray> requestLine = socket->readLine().trimmed().split(' ');
+    QByteArray method = requestLine.value(0);
+    QByteArray path = requestLine.value(1);
+    QString status = "200 OK";
+    QString contentType = "application/json";
+    QByteArray body = QByteArray();
+
+    if (method != "GET") {
+        status = "405 Method Not Allowed";
+        contentType = "text/plain";
+    } else if ((path == "/") || (path == "/stats")) {
+        std::shared_ptr<const QByteArray> snapshot = mStatsServer->snapshot();
+
+        body = snapshot?*snapshot:QByteArray("{}");
+    } else if (path == "/metrics") {
+        contentType = "text/plain; version=0.0.4";
+        body = Metrics::instance()->prometheusText();
+    } else {
+        status = "404 Not Found";
+        contentType = "text/plain";
+    }
+
+    socket->disconnect(this);
+
+    socket->write(Response.arg(status, contentType).arg(body.size()).toUtf8());
+    socket->write(body);
+    socket->disconnectFromServer();
+}
+
+//==============================================================================
+
+StatsServer::StatsServer() :
+    mSnapshot(nullptr)
+{
+    // Create our worker and have it listen for connections in its own thread,
+    // so that no request ever contends with our GUI thread
+
+    StatsServerWorker *worker = new StatsServerWorker(this);
+
+    worker->moveToThread(&mThread);
+
+    connect(&mThread, &QThread::started,
+            worker, &StatsServerWorker::listen);
+    connect(&mThread, &QThread::finished,
+            worker, &StatsServerWorker::deleteLater);
+
+    connect(qApp, &QCoreApplication::aboutToQuit,
+            this, &StatsServer::stop);
+
+    mThread.start();
+}
+
+//==============================================================================
+
+StatsServer::~StatsServer()
+{
+    // Stop ourselves
+
+    stop();
+}
+
+//==============================================================================
+
+QString StatsServer::serverName()
+{
+    // Return our server name
+    // Note: on Linux and macOS, our server lives in our per-user runtime
+    //       directory (rather than in the shared temporary directory), so that
+    //       no other local user can squat or spoof it...
+
+    QString res = QString("%1-stats").arg(QCoreApplication::applicationName());
+
+#ifndef Q_OS_WIN
+    QString runtimeLocation = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+
+    if (!runtimeLocation.isEmpty()) {
+        res = runtimeLocation+"/"+res;
+    }
+#endif
+
+    return res;
+}
+
+//==============================================================================
+
+std::shared_ptr<const QByteArray> StatsServer::snapshot() const
+{
+    // Return our current snapshot
+
+    return std::atomic_load(&mSnapshot);
+}
+
+//==============================================================================
+
+void StatsServer::setSnapshot(const QByteArray &pSnapshot)
+{
+    // Publish our new snapshot
+
+    std::atomic_store(&mSnapshot, std::shared_ptr<const QByteArray>(new QByteArray(pSnapshot)));
+}
+
+//==============================================================================
+
+void StatsServer::stop()
+{
+    // Stop our thread, if needed
+
+    if (mThread.isRunning()) {
+        mThread.quit();
+        mThread.wait();
+    }
+}
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,91 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Stats server
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QByteArray>
+#include <QObject>
+#include <QThread>
+
+//==============================================================================
+
+#include <memory>
+
+//==============================================================================
+
+class QLocalServer;
+
+//==============================================================================
+
+class StatsServer;
+
+//==============================================================================
+
+class StatsServerWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StatsServerWorker(const StatsServer *pStatsServer);
+
+private:
+    const StatsServer *mStatsServer;
+
+    QLocalServer *mLocalServer;
+
+public slots:
+    void listen();
+
+private slots:
+    void newConnection();
+    void readyRead();
+};
+
+//==============================================================================
+
+class StatsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StatsServer();
+    ~StatsServer() override;
+
+    static QString serverName();
+
+    std::shared_ptr<const QByteArray> snapshot() const;
+    void setSnapshot(const QByteArray &pSnapshot);
+
+private:
+    QThread mThread;
+
+    std::shared_ptr<const QByteArray> mSnapshot;
+
+public slots:
+    void stop();
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
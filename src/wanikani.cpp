@@ -1,1042 +1,3433 @@
-/*******************************************************************************
-
-Copyright Alan Garny
-
-Licensed under the Apache License, Version 2.0 (the "License");
-you may not use this file except in compliance with the License.
-You may obtain a copy of the License at
-
-    http://www.apache.org/licenses/LICENSE-2.0
-
-Unless required by applicable law or agreed to in writing, software
-distributed under the License is distributed on an "AS IS" BASIS,
-WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-See the License for the specific language governing permissions and
-limitations under the License.
-
-*******************************************************************************/
-
-//==============================================================================
-// WaniKani
-//==============================================================================
-
-#include "wanikani.h"
-
-//==============================================================================
-
-#include <QEventLoop>
-#include <QJsonObject>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QNetworkRequest>
-
-//==============================================================================
-
-#include "zlib.h"
-
-//==============================================================================
-
-void Common::reset()
-{
-    // Reset ourselves
-
-    mHasData = false;
-}
-
-//==============================================================================
-
-QDateTime User::currentVacationStartedAt() const
-{
-    // Return our current vacation start at
-
-    return mCurrentVacationStartedAt;
-}
-
-//==============================================================================
-
-int User::level() const
-{
-    // Return our level
-
-    return mLevel;
-}
-
-//==============================================================================
-
-QString User::profileUrl() const
-{
-    // Return our profile URL
-
-    return mProfileUrl;
-}
-
-//==============================================================================
-
-QString User::userName() const
-{
-    // Return our user name
-
-    return mUserName;
-}
-
-//==============================================================================
-
-int StudyQueue::lessonsAvailable() const
-{
-    // Return our number of lessons available
-
-    return mLessonsAvailable;
-}
-
-//==============================================================================
-
-int StudyQueue::reviewsAvailable() const
-{
-    // Return our number of reviews available
-
-    return mReviewsAvailable;
-}
-
-//==============================================================================
-
-uint StudyQueue::nextReviewDate() const
-{
-    // Return our next review date
-
-    return mNextReviewDate;
-}
-
-//==============================================================================
-
-int StudyQueue::reviewsAvailableNextHour() const
-{
-    // Return our number of reviews available within the next hour
-
-    return mReviewsAvailableNextHour;
-}
-
-//==============================================================================
-
-int StudyQueue::reviewsAvailableNextDay() const
-{
-    // Return our number of reviews available within the next day
-
-    return mReviewsAvailableNextDay;
-}
-
-//==============================================================================
-
-int LevelProgression::radicalsProgress() const
-{
-    // Return our radicals progress
-
-    return mRadicalsProgress;
-}
-
-//==============================================================================
-
-int LevelProgression::radicalsTotal() const
-{
-    // Return our total number of radicals
-
-    return mRadicalsTotal;
-}
-
-//==============================================================================
-
-int LevelProgression::kanjiProgress() const
-{
-    // Return our Kanji progress
-
-    return mKanjiProgress;
-}
-
-//==============================================================================
-
-int LevelProgression::kanjiTotal() const
-{
-    // Return our total number of Kanji
-
-    return mKanjiTotal;
-}
-
-//==============================================================================
-
-QString SrsDistributionInformation::name() const
-{
-    // Return our name
-
-    return mName;
-}
-
-//==============================================================================
-
-QString SrsDistributionInformation::radicals() const
-{
-    // Return our number of radicals
-
-    return mRadicals;
-}
-
-//==============================================================================
-
-QString SrsDistributionInformation::kanji() const
-{
-    // Return our number of Kanji
-
-    return mKanji;
-}
-
-//==============================================================================
-
-QString SrsDistributionInformation::vocabulary() const
-{
-    // Return our number of vocabulary
-
-    return mVocabulary;
-}
-
-//==============================================================================
-
-QString SrsDistributionInformation::total() const
-{
-    // Return our total
-
-    return mTotal;
-}
-
-//==============================================================================
-
-SrsDistributionInformation SrsDistribution::apprentice() const
-{
-    // Return our apprentice SRS distribution
-
-    return mApprentice;
-}
-
-//==============================================================================
-
-SrsDistributionInformation SrsDistribution::guru() const
-{
-    // Return our guru SRS distribution
-
-    return mGuru;
-}
-
-//==============================================================================
-
-SrsDistributionInformation SrsDistribution::master() const
-{
-    // Return our master SRS distribution
-
-    return mMaster;
-}
-
-//==============================================================================
-
-SrsDistributionInformation SrsDistribution::enlightened() const
-{
-    // Return our enlightened SRS distribution
-
-    return mEnlightened;
-}
-
-//==============================================================================
-
-SrsDistributionInformation SrsDistribution::burned() const
-{
-    // Return our burned SRS distribution
-
-    return mBurned;
-}
-
-//==============================================================================
-
-QChar Item::character() const
-{
-    // Return our character
-
-    return mCharacter;
-}
-
-//==============================================================================
-
-QString Item::meaning() const
-{
-    // Return our meaning
-
-    return mMeaning;
-}
-
-//==============================================================================
-
-int Item::level() const
-{
-    // Return our level
-
-    return mLevel;
-}
-
-//==============================================================================
-
-QString UserSpecific::srs() const
-{
-    // Return our SRS
-
-    return mSrs;
-}
-
-//==============================================================================
-
-int UserSpecific::srsNumeric() const
-{
-    // Return our SRS numeric
-
-    return mSrsNumeric;
-}
-
-//==============================================================================
-
-uint UserSpecific::unlockedDate() const
-{
-    // Return our unlocked date
-
-    return mUnlockedDate;
-}
-
-//==============================================================================
-
-uint UserSpecific::availableDate() const
-{
-    // Return our available date
-
-    return mAvailableDate;
-}
-
-//==============================================================================
-
-bool UserSpecific::burned() const
-{
-    // Return whether we are burned
-
-    return mBurned;
-}
-
-//==============================================================================
-
-uint UserSpecific::burnedDate() const
-{
-    // Return our burned date
-
-    return mBurnedDate;
-}
-
-//==============================================================================
-
-int UserSpecific::meaningCorrect() const
-{
-    // Return our number of correct meanings
-
-    return mMeaningCorrect;
-}
-
-//==============================================================================
-
-int UserSpecific::meaningIncorrect() const
-{
-    // Return our number of incorrect meanings
-
-    return mMeaningIncorrect;
-}
-
-//==============================================================================
-
-int UserSpecific::meaningMaxStreak() const
-{
-    // Return our maximum streak for the meaning
-
-    return mMeaningMaxStreak;
-}
-
-//==============================================================================
-
-int UserSpecific::meaningCurrentStreak() const
-{
-    // Return our current streak for the meaning
-
-    return mMeaningCurrentStreak;
-}
-
-//==============================================================================
-
-int UserSpecific::readingCorrect() const
-{
-    // Return our number of correct readings
-
-    return mReadingCorrect;
-}
-
-//==============================================================================
-
-int UserSpecific::readingIncorrect() const
-{
-    // Return our number of incorrect readings
-
-    return mReadingCorrect;
-}
-
-//==============================================================================
-
-int UserSpecific::readingMaxStreak() const
-{
-    // Return our maximum streak for the reading
-
-    return mReadingMaxStreak;
-}
-
-//==============================================================================
-
-int UserSpecific::readingCurrentStreak() const
-{
-    // Return our current streak for the reading
-
-    return mReadingCurrentStreak;
-}
-
-//==============================================================================
-
-QString UserSpecific::meaningNote() const
-{
-    // Return our meaning note
-
-    return mMeaningNote;
-}
-
-//==============================================================================
-
-QString UserSpecific::userSynonyms() const
-{
-    // Return our user synonyms
-
-    return mUserSynonyms;
-}
-
-//==============================================================================
-
-QString Radical::image() const
-{
-    // Return our image
-
-    return mImage;
-}
-
-//==============================================================================
-
-UserSpecific Radical::userSpecific() const
-{
-    // Return our user specific information
-
-    return mUserSpecific;
-}
-
-//==============================================================================
-
-QString ExtraUserSpecific::readingNote() const
-{
-    // Return our reading note
-
-    return mReadingNote;
-}
-
-//==============================================================================
-
-QString Kanji::onyomi() const
-{
-    // Return our Onyomi reading
-
-    return mOnyomi;
-}
-
-//==============================================================================
-
-QString Kanji::kunyomi() const
-{
-    // Return our Kunyomi reading
-
-    return mKunyomi;
-}
-
-//==============================================================================
-
-QString Kanji::nanori() const
-{
-    // Return our Nanori reading
-
-    return mNanori;
-}
-
-//==============================================================================
-
-QString Kanji::imporantReading() const
-{
-    // Return our important reading
-
-    return mImportantReading;
-}
-
-//==============================================================================
-
-ExtraUserSpecific Kanji::userSpecific() const
-{
-    // Return our user specific information
-
-    return mUserSpecific;
-}
-
-//==============================================================================
-
-QString Vocabulary::kana() const
-{
-    // Return our Kana reading
-
-    return mKana;
-}
-
-//==============================================================================
-
-ExtraUserSpecific Vocabulary::userSpecific() const
-{
-    // Return our user specific information
-
-    return mUserSpecific;
-}
-
-//==============================================================================
-
-WaniKani::WaniKani()
-{
-    mNetworkAccessManager = new QNetworkAccessManager();
-}
-
-//==============================================================================
-
-WaniKani::~WaniKani()
-{
-    delete mNetworkAccessManager;
-}
-
-//==============================================================================
-
-void WaniKani::setApiKeyAndToken(const QString &pApiKey,
-                                 const QString &pApiToken)
-{
-    // Set our API key and token, and update our information
-
-    mApiKey = pApiKey;
-    mApiToken = pApiToken;
-
-    update();
-}
-
-//==============================================================================
-
-QNetworkReply * WaniKani::waniKaniNetworkReply(const QString &pRequest)
-{
-    // Send a request to WaniKani, asking for its response to be compressed, and
-    // then convert its response to a JSON document, if possible and after
-    // having uncompressed it
-
-    QNetworkRequest networkRequest(QString("https://www.wanikani.com/api/v1.4/user/%1/%2").arg(mApiKey, pRequest));
-
-    networkRequest.setRawHeader("Accept-Encoding", "gzip");
-
-    return mNetworkAccessManager->get(networkRequest);
-}
-
-//==============================================================================
-
-QNetworkReply * WaniKani::waniKaniV2NetworkReply(const QString &pRequest)
-{
-    // Send a request to WaniKani, asking for its response to be compressed, and
-    // then convert its response to a JSON document, if possible and after
-    // having uncompressed it
-
-    QNetworkRequest networkRequest(QString("https://api.wanikani.com/v2/%1").arg(pRequest));
-
-    networkRequest.setRawHeader("Accept-Encoding", "gzip");
-    networkRequest.setRawHeader("Wanikani-Revision", "20170710");
-    networkRequest.setRawHeader("Authorization", QString("Bearer %1").arg(mApiToken).toUtf8());
-
-    return mNetworkAccessManager->get(networkRequest);
-}
-
-//==============================================================================
-
-QJsonDocument WaniKani::waniKaniJsonResponse(QNetworkReply *pNetworkReply)
-{
-    QByteArray response = QByteArray();
-
-    if (pNetworkReply->error() == QNetworkReply::NoError) {
-        response = pNetworkReply->readAll();
-    }
-
-    pNetworkReply->deleteLater();
-
-    if (response.isEmpty()) {
-        return QJsonDocument();
-    } else {
-        // Uncompress the response
-
-        z_stream stream;
-        QByteArray json = QByteArray();
-
-        memset(&stream, 0, sizeof(z_stream));
-
-        if (inflateInit2_(&stream, MAX_WBITS+16, ZLIB_VERSION, sizeof(z_stream)) == Z_OK) {
-            enum {
-                BufferSize = 32768
-            };
-
-            Bytef buffer[BufferSize];
-
-            stream.next_in = reinterpret_cast<Bytef *>(response.data());
-            stream.avail_in = uint(response.size());
-
-            do {
-                stream.next_out = buffer;
-                stream.avail_out = BufferSize;
-
-                inflate(&stream, Z_NO_FLUSH);
-
-                if (!stream.msg) {
-                    json += QByteArray::fromRawData(reinterpret_cast<char *>(buffer), BufferSize-int(stream.avail_out));
-                } else {
-                    json = QByteArray();
-                }
-            } while (!stream.avail_out);
-
-            inflateEnd(&stream);
-        } else {
-            return QJsonDocument();
-        }
-
-        // Convert the response to a JSON document
-
-        QJsonDocument res = QJsonDocument::fromJson(json);
-
-        return res.object().toVariantMap()["error"].toMap().count()?QJsonDocument():res;
-    }
-}
-
-//==============================================================================
-
-bool WaniKani::validJsonDocument(const QJsonDocument &pJsonDocument)
-{
-    // Return whether the given JSON document is valid
-
-    return !pJsonDocument.isNull() && !pJsonDocument.object().contains("error");
-}
-
-//==============================================================================
-
-void WaniKani::userReply()
-{
-    // Retrieve, if available, the user's information
-
-    mUserResponse = waniKaniJsonResponse(qobject_cast<QNetworkReply *>(sender()));
-
-    if (validJsonDocument(mUserResponse)) {
-        QVariantMap userResponseMap = mUserResponse.object().toVariantMap()["data"].toMap();
-
-        mUser.mHasData = true;
-        mUser.mCurrentVacationStartedAt = QDateTime::fromString(userResponseMap["current_vacation_started_at"].toString(), Qt::ISODate);
-        mUser.mLevel = userResponseMap["level"].toInt();
-        mUser.mProfileUrl = userResponseMap["profile_url"].toString();
-        mUser.mUserName = userResponseMap["username"].toString();
-    }
-
-    checkNbOfReplies();
-}
-
-//==============================================================================
-
-void WaniKani::studyQueueReply()
-{
-    // Retrieve, if available, some of the user's information, the user's study
-    // queu and the user's gravatar
-
-    mStudyQueueResponse = waniKaniJsonResponse(qobject_cast<QNetworkReply *>(sender()));
-
-    if (validJsonDocument(mStudyQueueResponse)) {
-        QVariantMap studyQueueMap = mStudyQueueResponse.object().toVariantMap()["requested_information"].toMap();
-
-        mStudyQueue.mLessonsAvailable = studyQueueMap["lessons_available"].toInt();
-        mStudyQueue.mReviewsAvailable = studyQueueMap["reviews_available"].toInt();
-        mStudyQueue.mNextReviewDate = studyQueueMap["next_review_date"].toUInt();
-        mStudyQueue.mReviewsAvailableNextHour = studyQueueMap["reviews_available_next_hour"].toInt();
-        mStudyQueue.mReviewsAvailableNextDay = studyQueueMap["reviews_available_next_day"].toInt();
-    }
-
-    checkNbOfReplies();
-}
-
-//==============================================================================
-
-void WaniKani::levelProgressionReply()
-{
-    // Retrieve, if available, the user's level progression
-
-    mLevelProgressionResponse = waniKaniJsonResponse(qobject_cast<QNetworkReply *>(sender()));
-
-    if (validJsonDocument(mLevelProgressionResponse)) {
-        QVariantMap levelProgressionResponseMap = mLevelProgressionResponse.object().toVariantMap()["requested_information"].toMap();
-
-        mLevelProgression.mRadicalsProgress = levelProgressionResponseMap["radicals_progress"].toInt();
-        mLevelProgression.mRadicalsTotal = levelProgressionResponseMap["radicals_total"].toInt();
-        mLevelProgression.mKanjiProgress = levelProgressionResponseMap["kanji_progress"].toInt();
-        mLevelProgression.mKanjiTotal = levelProgressionResponseMap["kanji_total"].toInt();
-    }
-
-    checkNbOfReplies();
-}
-
-//==============================================================================
-
-void WaniKani::srsDistributionReply()
-{
-    // Retrieve, if available, the user's SRS distribution
-
-    mSrsDistributionResponse = waniKaniJsonResponse(qobject_cast<QNetworkReply *>(sender()));
-
-    if (validJsonDocument(mSrsDistributionResponse)) {
-        QVariantMap srsDistributionMap = mSrsDistributionResponse.object().toVariantMap()["requested_information"].toMap();
-
-        updateSrsDistribution("Apprentice", srsDistributionMap["apprentice"].toMap(), mSrsDistribution.mApprentice);
-        updateSrsDistribution("Guru", srsDistributionMap["guru"].toMap(), mSrsDistribution.mGuru);
-        updateSrsDistribution("Master", srsDistributionMap["master"].toMap(), mSrsDistribution.mMaster);
-        updateSrsDistribution("Enlightened", srsDistributionMap["enlighten"].toMap(), mSrsDistribution.mEnlightened);
-        updateSrsDistribution("Burned", srsDistributionMap["burned"].toMap(), mSrsDistribution.mBurned);
-    }
-
-    checkNbOfReplies();
-}
-
-//==============================================================================
-
-void WaniKani::radicalsReply()
-{
-    // Retrieve, if available, the radicals and their information
-
-    mRadicalsResponse = waniKaniJsonResponse(qobject_cast<QNetworkReply *>(sender()));
-
-    if (validJsonDocument(mRadicalsResponse)) {
-        mRadicals = Radicals();
-
-        for (const auto &radicalInformation : mRadicalsResponse.object().toVariantMap()["requested_information"].toList()) {
-            QVariantMap radicalInformationMap = radicalInformation.toMap();
-            Radical radical;
-
-            radical.mCharacter = radicalInformationMap["character"].toString()[0];
-            radical.mMeaning = radicalInformationMap["meaning"].toString();
-            radical.mImage = radicalInformationMap["image"].toString();
-            radical.mLevel = radicalInformationMap["level"].toInt();
-
-            QVariantMap radicalUserSpecificInformationMap = radicalInformationMap["user_specific"].toMap();
-
-            radical.mUserSpecific.mSrs = radicalUserSpecificInformationMap["srs"].toString();
-            radical.mUserSpecific.mSrsNumeric = radicalUserSpecificInformationMap["srs_numeric"].toInt();
-            radical.mUserSpecific.mUnlockedDate = radicalUserSpecificInformationMap["unlocked_date"].toUInt();
-            radical.mUserSpecific.mAvailableDate = radicalUserSpecificInformationMap["burned"].toBool()?0:radicalUserSpecificInformationMap["available_date"].toUInt();
-            radical.mUserSpecific.mBurned = radicalUserSpecificInformationMap["burned"].toBool();
-            radical.mUserSpecific.mBurnedDate = radicalUserSpecificInformationMap["burned_date"].toUInt();
-            radical.mUserSpecific.mMeaningCorrect = radicalUserSpecificInformationMap["meaning_correct"].toInt();
-            radical.mUserSpecific.mMeaningIncorrect = radicalUserSpecificInformationMap["meaning_incorrect"].toInt();
-            radical.mUserSpecific.mMeaningMaxStreak = radicalUserSpecificInformationMap["meaning_max_streak"].toInt();
-            radical.mUserSpecific.mMeaningCurrentStreak = radicalUserSpecificInformationMap["meaning_current_streak"].toInt();
-            radical.mUserSpecific.mReadingCorrect = radicalUserSpecificInformationMap["reading_correct"].toInt();
-            radical.mUserSpecific.mReadingIncorrect = radicalUserSpecificInformationMap["reading_incorrect"].toInt();
-            radical.mUserSpecific.mReadingMaxStreak = radicalUserSpecificInformationMap["reading_max_streak"].toInt();
-            radical.mUserSpecific.mReadingCurrentStreak = radicalUserSpecificInformationMap["reading_current_streak"].toInt();
-            radical.mUserSpecific.mMeaningNote = radicalUserSpecificInformationMap["meaning_note"].toString();
-            radical.mUserSpecific.mUserSynonyms = radicalUserSpecificInformationMap["user_synonyms"].toString();
-
-            mRadicals << radical;
-        }
-    }
-
-    checkNbOfReplies();
-}
-
-//==============================================================================
-
-void WaniKani::kanjiReply()
-{
-    // Retrieve, if available, the Kanji and their information
-
-    mKanjiResponse = waniKaniJsonResponse(qobject_cast<QNetworkReply *>(sender()));
-
-    if (validJsonDocument(mKanjiResponse)) {
-        mKanjis = Kanjis();
-
-        for (const auto &kanjiInformation : mKanjiResponse.object().toVariantMap()["requested_information"].toList()) {
-            QVariantMap kanjiInformationMap = kanjiInformation.toMap();
-            Kanji kanji;
-
-            kanji.mCharacter = kanjiInformationMap["character"].toString()[0];
-            kanji.mMeaning = kanjiInformationMap["meaning"].toString();
-            kanji.mOnyomi = kanjiInformationMap["onyomi"].toString();
-            kanji.mKunyomi = kanjiInformationMap["kunyomi"].toString();
-            kanji.mNanori = kanjiInformationMap["nanori"].toString();
-            kanji.mImportantReading = kanjiInformationMap["important_reading"].toString();
-            kanji.mLevel = kanjiInformationMap["level"].toInt();
-
-            QVariantMap kanjiUserSpecificInformationMap = kanjiInformationMap["user_specific"].toMap();
-
-            kanji.mUserSpecific.mSrs = kanjiUserSpecificInformationMap["srs"].toString();
-            kanji.mUserSpecific.mSrsNumeric = kanjiUserSpecificInformationMap["srs_numeric"].toInt();
-            kanji.mUserSpecific.mUnlockedDate = kanjiUserSpecificInformationMap["unlocked_date"].toUInt();
-            kanji.mUserSpecific.mAvailableDate = kanjiUserSpecificInformationMap["burned"].toBool()?0:kanjiUserSpecificInformationMap["available_date"].toUInt();
-            kanji.mUserSpecific.mBurned = kanjiUserSpecificInformationMap["burned"].toBool();
-            kanji.mUserSpecific.mBurnedDate = kanjiUserSpecificInformationMap["burned_date"].toUInt();
-            kanji.mUserSpecific.mMeaningCorrect = kanjiUserSpecificInformationMap["meaning_correct"].toInt();
-            kanji.mUserSpecific.mMeaningIncorrect = kanjiUserSpecificInformationMap["meaning_incorrect"].toInt();
-            kanji.mUserSpecific.mMeaningMaxStreak = kanjiUserSpecificInformationMap["meaning_max_streak"].toInt();
-            kanji.mUserSpecific.mMeaningCurrentStreak = kanjiUserSpecificInformationMap["meaning_current_streak"].toInt();
-            kanji.mUserSpecific.mReadingCorrect = kanjiUserSpecificInformationMap["reading_correct"].toInt();
-            kanji.mUserSpecific.mReadingIncorrect = kanjiUserSpecificInformationMap["reading_incorrect"].toInt();
-            kanji.mUserSpecific.mReadingMaxStreak = kanjiUserSpecificInformationMap["reading_max_streak"].toInt();
-            kanji.mUserSpecific.mReadingCurrentStreak = kanjiUserSpecificInformationMap["reading_current_streak"].toInt();
-            kanji.mUserSpecific.mMeaningNote = kanjiUserSpecificInformationMap["meaning_note"].toString();
-            kanji.mUserSpecific.mUserSynonyms = kanjiUserSpecificInformationMap["user_synonyms"].toString();
-            kanji.mUserSpecific.mReadingNote = kanjiUserSpecificInformationMap["reading_note"].toString();
-
-            mKanjis << kanji;
-        }
-    }
-
-    checkNbOfReplies();
-}
-
-//==============================================================================
-
-void WaniKani::vocabularyReply()
-{
-    // Retrieve, if available, the vocabularies and their information
-
-    mVocabularyResponse = waniKaniJsonResponse(qobject_cast<QNetworkReply *>(sender()));
-
-    if (validJsonDocument(mVocabularyResponse)) {
-        mVocabularies = Vocabularies();
-
-        for (const auto &vocabularyInformation : mVocabularyResponse.object().toVariantMap()["requested_information"].toList()) {
-            QVariantMap vocabularyInformationMap = vocabularyInformation.toMap();
-            Vocabulary vocabulary;
-
-            vocabulary.mCharacter = vocabularyInformationMap["character"].toString()[0];
-            vocabulary.mKana = vocabularyInformationMap["kana"].toString();
-            vocabulary.mMeaning = vocabularyInformationMap["meaning"].toString();
-            vocabulary.mLevel = vocabularyInformationMap["level"].toInt();
-
-            QVariantMap vocabularyUserSpecificInformationMap = vocabularyInformationMap["user_specific"].toMap();
-
-            vocabulary.mUserSpecific.mSrs = vocabularyUserSpecificInformationMap["srs"].toString();
-            vocabulary.mUserSpecific.mSrsNumeric = vocabularyUserSpecificInformationMap["srs_numeric"].toInt();
-            vocabulary.mUserSpecific.mUnlockedDate = vocabularyUserSpecificInformationMap["unlocked_date"].toUInt();
-            vocabulary.mUserSpecific.mAvailableDate = vocabularyUserSpecificInformationMap["burned"].toBool()?0:vocabularyUserSpecificInformationMap["available_date"].toUInt();
-            vocabulary.mUserSpecific.mBurned = vocabularyUserSpecificInformationMap["burned"].toBool();
-            vocabulary.mUserSpecific.mBurnedDate = vocabularyUserSpecificInformationMap["burned_date"].toUInt();
-            vocabulary.mUserSpecific.mMeaningCorrect = vocabularyUserSpecificInformationMap["meaning_correct"].toInt();
-            vocabulary.mUserSpecific.mMeaningIncorrect = vocabularyUserSpecificInformationMap["meaning_incorrect"].toInt();
-            vocabulary.mUserSpecific.mMeaningMaxStreak = vocabularyUserSpecificInformationMap["meaning_max_streak"].toInt();
-            vocabulary.mUserSpecific.mMeaningCurrentStreak = vocabularyUserSpecificInformationMap["meaning_current_streak"].toInt();
-            vocabulary.mUserSpecific.mReadingCorrect = vocabularyUserSpecificInformationMap["reading_correct"].toInt();
-            vocabulary.mUserSpecific.mReadingIncorrect = vocabularyUserSpecificInformationMap["reading_incorrect"].toInt();
-            vocabulary.mUserSpecific.mReadingMaxStreak = vocabularyUserSpecificInformationMap["reading_max_streak"].toInt();
-            vocabulary.mUserSpecific.mReadingCurrentStreak = vocabularyUserSpecificInformationMap["reading_current_streak"].toInt();
-            vocabulary.mUserSpecific.mMeaningNote = vocabularyUserSpecificInformationMap["meaning_note"].toString();
-            vocabulary.mUserSpecific.mUserSynonyms = vocabularyUserSpecificInformationMap["user_synonyms"].toString();
-            vocabulary.mUserSpecific.mReadingNote = vocabularyUserSpecificInformationMap["reading_note"].toString();
-
-            mVocabularies << vocabulary;
-        }
-    }
-
-    checkNbOfReplies();
-}
-
-//==============================================================================
-
-void WaniKani::checkNbOfReplies()
-{
-    // Increase our number of replies and, if we have got the number we are
-    // after, let people know whether things are valid or not
-
-    ++mNbOfReplies;
-
-    if (mNbOfReplies == mNbOfNeededReplies) {
-        if (   validJsonDocument(mUserResponse)
-            || validJsonDocument(mStudyQueueResponse)
-            || validJsonDocument(mLevelProgressionResponse)
-            || validJsonDocument(mSrsDistributionResponse)
-            || validJsonDocument(mRadicalsResponse)
-            || validJsonDocument(mKanjiResponse)
-            || validJsonDocument(mVocabularyResponse)) {
-            // Let people know that we have been updated
-
-            emit updated();
-        } else {
-            // Let people know that something went wrong
-
-            emit error();
-        }
-    }
-}
-
-//==============================================================================
-
-void WaniKani::doUpdate(bool pForce)
-{
-    // Make sure that we have an API key
-
-    bool hasApiKey = !mApiKey.isEmpty();
-    bool hasApiToken = !mApiToken.isEmpty();
-
-    if (!hasApiKey && !hasApiToken) {
-        emit error();
-
-        return;
-    }
-
-    // Retrieve
-    //  - the user's information and study queue
-    //  - the user's SRS distribution
-    //  - the user's list of radicals (and their information)
-    //  - the user's list of Kanji (and their information)
-    //  - the user's list of vocabulary (and their information)
-
-    bool retrieveData = !mApiKey.isEmpty();
-    bool retrieveV2Data = !mApiToken.isEmpty() && (pForce || !mUser.mHasData);
-
-    mNbOfReplies = 0;
-    mNbOfNeededReplies = 6*int(retrieveData)+int(retrieveV2Data);
-
-    if (retrieveV2Data) {
-        QObject::connect(waniKaniV2NetworkReply("user"), &QNetworkReply::finished,
-                         this, &WaniKani::userReply);
-    }
-
-    if (retrieveData) {
-        QObject::connect(waniKaniNetworkReply("study-queue"), &QNetworkReply::finished,
-                         this, &WaniKani::studyQueueReply);
-        QObject::connect(waniKaniNetworkReply("level-progression"), &QNetworkReply::finished,
-                         this, &WaniKani::levelProgressionReply);
-        QObject::connect(waniKaniNetworkReply("srs-distribution"), &QNetworkReply::finished,
-                         this, &WaniKani::srsDistributionReply);
-        QObject::connect(waniKaniNetworkReply("radicals/1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60"), &QNetworkReply::finished,
-                         this, &WaniKani::radicalsReply);
-        QObject::connect(waniKaniNetworkReply("kanji/1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60"), &QNetworkReply::finished,
-                         this, &WaniKani::kanjiReply);
-        QObject::connect(waniKaniNetworkReply("vocabulary/1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60"), &QNetworkReply::finished,
-                         this, &WaniKani::vocabularyReply);
-    }
-}
-
-//==============================================================================
-
-void WaniKani::update()
-{
-    // Update ourselves
-
-    doUpdate();
-}
-
-//==============================================================================
-
-void WaniKani::forceUpdate()
-{
-    // Forcely update ourselves
-
-    doUpdate(true);
-}
-
-//==============================================================================
-
-void WaniKani::updateSrsDistribution(const QString &pName,
-                                     const QVariantMap &pVariantMap,
-                                     SrsDistributionInformation &pSrsDistributionInformation)
-{
-    // Update the given SRS distribution information using the given variant map
-
-    pSrsDistributionInformation.mName = pName;
-    pSrsDistributionInformation.mRadicals = pVariantMap["radicals"].toString();
-    pSrsDistributionInformation.mKanji = pVariantMap["kanji"].toString();
-    pSrsDistributionInformation.mVocabulary = pVariantMap["vocabulary"].toString();
-    pSrsDistributionInformation.mTotal = pVariantMap["total"].toString();
-}
-
-//==============================================================================
-
-User WaniKani::user() const
-{
-    // Return our user
-
-    return mUser;
-}
-
-//==============================================================================
-
-StudyQueue WaniKani::studyQueue() const
-{
-    // Return our study queue
-
-    return mStudyQueue;
-}
-
-//==============================================================================
-
-LevelProgression WaniKani::levelProgression() const
-{
-    // Return our level progression
-
-    return mLevelProgression;
-}
-
-//==============================================================================
-
-SrsDistribution WaniKani::srsDistribution() const
-{
-    // Return our SRS distribution
-
-    return mSrsDistribution;
-}
-
-//==============================================================================
-
-Radicals WaniKani::radicals() const
-{
-    // Return our list of radicals
-
-    return mRadicals;
-}
-
-//==============================================================================
-
-Kanjis WaniKani::kanjis() const
-{
-    // Return our list of Kanji
-
-    return mKanjis;
-}
-
-//==============================================================================
-
-Vocabularies WaniKani::vocabularies() const
-{
-    // Return our list of vocabulary
-
-    return mVocabularies;
-}
-
-//==============================================================================
-// End of file
-//==============================================================================
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// WaniKani
+//==============================================================================
+
+#include "inflater.h"
+#include "wanikani.h"
+
+//==============================================================================
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QSslConfiguration>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QUrl>
+#include <QtConcurrentRun>
+
+//==============================================================================
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+
+#include "zlib.h"
+
+//==============================================================================
+
+static const char *GenerationProperty = "Generation";
+static const char *StartTimeProperty = "StartTime";
+static const char *EncryptedTimeProperty = "EncryptedTime";
+static const char *SessionTicketProperty = "SessionTicket";
+static const char *StaleEndpointsProperty = "StaleEndpoints";
+
+//==============================================================================
+
+static const int V2RateLimit = 60;          // Requests per minute
+static const double V2TokensPerMs = V2RateLimit/60000.0;
+
+//==============================================================================
+
+static const auto WaniKaniHost    = QStringLiteral("www.wanikani.com");
+static const auto WaniKaniApiHost = QStringLiteral("api.wanikani.com");
+
+
+//==============================================================================
+
+static const quint32 SubjectsFileMagic = 0x574b5342;   // "WKSB"
+static const quint32 SubjectsFileVersion = 2;
+
+//==============================================================================
+
+// Time to live (in seconds) of our different endpoints
+// Note: the study queue is always retrieved since it tells us whether our other
+//       endpoints have changed (see requestStaleEndpoints())...
+
+static const qint64 EndpointTimesToLive[Metrics::NbOfEndpoints] = {
+    0,        // User (retrieved only once, see doUpdate())
+    0,        // Study queue
+    86400,    // Level progression (cross-check, see deriveInformation())
+    86400,    // SRS distribution (cross-check, see deriveInformation())
+    86400,    // Radicals
+    6*3600,   // Kanji
+    6*3600,   // Vocabulary
+    86400,    // Subjects (independent of the user's progress)
+    6*3600,   // Assignments
+    6*3600    // Review statistics
+};
+
+//==============================================================================
+
+QStringRef ArenaString::ref() const
+{
+    // Return a view of our string in our arena
+
+    return mArena?QStringRef(&mArena->mStrings, mPosition, mSize):QStringRef();
+}
+
+//==============================================================================
+
+QString ArenaString::toString() const
+{
+    // Return a copy of our string
+
+    return ref().toString();
+}
+
+//==============================================================================
+
+ArenaString StringArena::add(const QString &pString)
+{
+    // Append the given string to our (contiguous) strings, unless we already
+    // have it, and return where it can be found
+    // Note: our strings may get reallocated as we add strings, so we refer to
+    //       them rather than to their data. Also, a string shares the ownership
+    //       of its arena, so that it remains valid for as long as it (i.e. a
+    //       copy of its item) is around, which means that we must be owned by
+    //       a shared pointer...
+
+    ArenaString res;
+
+    if (!pString.isEmpty()) {
+        int position = mPositions.value(QStringRef(&pString), -1);
+
+        res.mArena = shared_from_this();
+        res.mSize = pString.size();
+
+        if (position == -1) {
+            res.mPosition = mStrings.size();
+
+            mStrings += pString;
+
+            mPositions.insert(QStringRef(&mStrings, res.mPosition, res.mSize), res.mPosition);
+        } else {
+            res.mPosition = position;
+        }
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+void StringArena::squeeze()
+{
+    // Release the memory we don't need, now that we have got all our strings
+    // Note: this includes the positions of our strings, i.e. we won't be able
+    //       to deduplicate any further string...
+
+    mStrings.squeeze();
+
+    mPositions = QHash<QStringRef, int>();
+}
+
+//==============================================================================
+
+void Common::reset()
+{
+    // Reset ourselves
+
+    mHasData = false;
+}
+
+//==============================================================================
+
+QDateTime User::currentVacationStartedAt() const
+{
+    // Return our current vacation start at
+
+    return mCurrentVacationStartedAt;
+}
+
+//==============================================================================
+
+int User::level() const
+{
+    // Return our level
+
+    return mLevel;
+}
+
+//==============================================================================
+
+QString User::profileUrl() const
+{
+    // Return our profile URL
+
+    return mProfileUrl;
+}
+
+//==============================================================================
+
+QString User::userName() const
+{
+    // Return our user name
+
+    return mUserName;
+}
+
+//==============================================================================
+
+int StudyQueue::lessonsAvailable() const
+{
+    // Return our number of lessons available
+
+    return mLessonsAvailable;
+}
+
+//==============================================================================
+
+int StudyQueue::reviewsAvailable() const
+{
+    // Return our number of reviews available
+
+    return mReviewsAvailable;
+}
+
+//==============================================================================
+
+uint StudyQueue::nextReviewDate() const
+{
+    // Return our next review date
+
+    return mNextReviewDate;
+}
+
+//==============================================================================
+
+int StudyQueue::reviewsAvailableNextHour() const
+{
+    // Return our number of reviews available within the next hour
+
+    return mReviewsAvailableNextHour;
+}
+
+//==============================================================================
+
+int StudyQueue::reviewsAvailableNextDay() const
+{
+    // Return our number of reviews available within the next day
+
+    return mReviewsAvailableNextDay;
+}
+
+//==============================================================================
+
+int LevelProgression::radicalsProgress() const
+{
+    // Return our radicals progress
+
+    return mRadicalsProgress;
+}
+
+//==============================================================================
+
+int LevelProgression::radicalsTotal() const
+{
+    // Return our total number of radicals
+
+    return mRadicalsTotal;
+}
+
+//==============================================================================
+
+int LevelProgression::kanjiProgress() const
+{
+    // Return our Kanji progress
+
+    return mKanjiProgress;
+}
+
+//==============================================================================
+
+int LevelProgression::kanjiTotal() const
+{
+    // Return our total number of Kanji
+
+    return mKanjiTotal;
+}
+
+//==============================================================================
+
+QString SrsDistributionInformation::name() const
+{
+    // Return our name
+
+    return mName;
+}
+
+//==============================================================================
+
+QString SrsDistributionInformation::radicals() const
+{
+    // Return our number of radicals
+
+    return mRadicals;
+}
+
+//==============================================================================
+
+QString SrsDistributionInformation::kanji() const
+{
+    // Return our number of Kanji
+
+    return mKanji;
+}
+
+//==============================================================================
+
+QString SrsDistributionInformation::vocabulary() const
+{
+    // Return our number of vocabulary
+
+    return mVocabulary;
+}
+
+//==============================================================================
+
+QString SrsDistributionInformation::total() const
+{
+    // Return our total
+
+    return mTotal;
+}
+
+//==============================================================================
+
+SrsDistributionInformation SrsDistribution::apprentice() const
+{
+    // Return our apprentice SRS distribution
+
+    return mApprentice;
+}
+
+//==============================================================================
+
+SrsDistributionInformation SrsDistribution::guru() const
+{
+    // Return our guru SRS distribution
+
+    return mGuru;
+}
+
+//==============================================================================
+
+SrsDistributionInformation SrsDistribution::master() const
+{
+    // Return our master SRS distribution
+
+    return mMaster;
+}
+
+//==============================================================================
+
+SrsDistributionInformation SrsDistribution::enlightened() const
+{
+    // Return our enlightened SRS distribution
+
+    return mEnlightened;
+}
+
+//==============================================================================
+
+SrsDistributionInformation SrsDistribution::burned() const
+{
+    // Return our burned SRS distribution
+
+    return mBurned;
+}
+
+//==============================================================================
+
+int Item::id() const
+{
+    // Return our id
+    // Note: only items that come from a subject have an id...
+
+    return mId;
+}
+
+//==============================================================================
+
+QStringRef Item::characters() const
+{
+    // Return our characters
+
+    return mCharacters.ref();
+}
+
+//==============================================================================
+
+QStringRef Item::meaning() const
+{
+    // Return our meaning
+
+    return mMeaning.ref();
+}
+
+//==============================================================================
+
+int Item::level() const
+{
+    // Return our level
+
+    return mLevel;
+}
+
+//==============================================================================
+
+QString UserSpecific::srs() const
+{
+    // Return our SRS
+
+    return mSrs;
+}
+
+//==============================================================================
+
+int UserSpecific::srsNumeric() const
+{
+    // Return our SRS numeric
+
+    return mSrsNumeric;
+}
+
+//==============================================================================
+
+uint UserSpecific::unlockedDate() const
+{
+    // Return our unlocked date
+
+    return mUnlockedDate;
+}
+
+//==============================================================================
+
+uint UserSpecific::availableDate() const
+{
+    // Return our available date
+
+    return mAvailableDate;
+}
+
+//==============================================================================
+
+bool UserSpecific::burned() const
+{
+    // Return whether we are burned
+
+    return mBurned;
+}
+
+//==============================================================================
+
+uint UserSpecific::burnedDate() const
+{
+    // Return our burned date
+
+    return mBurnedDate;
+}
+
+//==============================================================================
+
+int UserSpecific::meaningCorrect() const
+{
+    // Return our number of correct meanings
+
+    return mMeaningCorrect;
+}
+
+//==============================================================================
+
+int UserSpecific::meaningIncorrect() const
+{
+    // Return our number of incorrect meanings
+
+    return mMeaningIncorrect;
+}
+
+//==============================================================================
+
+int UserSpecific::meaningMaxStreak() const
+{
+    // Return our maximum streak for the meaning
+
+    return mMeaningMaxStreak;
+}
+
+//==============================================================================
+
+int UserSpecific::meaningCurrentStreak() const
+{
+    // Return our current streak for the meaning
+
+    return mMeaningCurrentStreak;
+}
+
+//==============================================================================
+
+int UserSpecific::readingCorrect() const
+{
+    // Return our number of correct readings
+
+    return mReadingCorrect;
+}
+
+//==============================================================================
+
+int UserSpecific::readingIncorrect() const
+{
+    // Return our number of incorrect readings
+
+    return mReadingCorrect;
+}
+
+//==============================================================================
+
+int UserSpecific::readingMaxStreak() const
+{
+    // Return our maximum streak for the reading
+
+    return mReadingMaxStreak;
+}
+
+//==============================================================================
+
+int UserSpecific::readingCurrentStreak() const
+{
+    // Return our current streak for the reading
+
+    return mReadingCurrentStreak;
+}
+
+//==============================================================================
+
+QStringRef UserSpecific::meaningNote() const
+{
+    // Return our meaning note
+
+    return mMeaningNote.ref();
+}
+
+//==============================================================================
+
+QStringRef UserSpecific::userSynonyms() const
+{
+    // Return our user synonyms
+
+    return mUserSynonyms.ref();
+}
+
+//==============================================================================
+
+QStringRef Radical::image() const
+{
+    // Return our image
+
+    return mImage.ref();
+}
+
+//==============================================================================
+
+const UserSpecific & Radical::userSpecific() const
+{
+    // Return our user specific information
+
+    return mUserSpecific;
+}
+
+//==============================================================================
+
+QStringRef ExtraUserSpecific::readingNote() const
+{
+    // Return our reading note
+
+    return mReadingNote.ref();
+}
+
+//==============================================================================
+
+QChar Kanji::character() const
+{
+    // Return our character
+    // Note: a Kanji always consists of one (non-surrogate) character...
+
+    QStringRef characters = mCharacters.ref();
+
+    return characters.isEmpty()?QChar():characters.at(0);
+}
+
+//==============================================================================
+
+QStringRef Kanji::onyomi() const
+{
+    // Return our Onyomi reading
+
+    return mOnyomi.ref();
+}
+
+//==============================================================================
+
+QStringRef Kanji::kunyomi() const
+{
+    // Return our Kunyomi reading
+
+    return mKunyomi.ref();
+}
+
+//==============================================================================
+
+QStringRef Kanji::nanori() const
+{
+    // Return our Nanori reading
+
+    return mNanori.ref();
+}
+
+//==============================================================================
+
+QStringRef Kanji::imporantReading() const
+{
+    // Return our important reading
+
+    return mImportantReading.ref();
+}
+
+//==============================================================================
+
+const ExtraUserSpecific & Kanji::userSpecific() const
+{
+    // Return our user specific information
+
+    return mUserSpecific;
+}
+
+//==============================================================================
+
+QStringRef Vocabulary::kana() const
+{
+    // Return our Kana reading
+
+    return mKana.ref();
+}
+
+//==============================================================================
+
+const ExtraUserSpecific & Vocabulary::userSpecific() const
+{
+    // Return our user specific information
+
+    return mUserSpecific;
+}
+
+//==============================================================================
+
+int ItemColumns::count() const
+{
+    // Return our number of items
+
+    return mTypes.count();
+}
+
+//==============================================================================
+
+const QVector<int> & ItemColumns::types() const
+{
+    // Return the types of our items
+
+    return mTypes;
+}
+
+//==============================================================================
+
+const QVector<int> & ItemColumns::levels() const
+{
+    // Return the levels of our items
+
+    return mLevels;
+}
+
+//==============================================================================
+
+const QVector<int> & ItemColumns::srsLevels() const
+{
+    // Return the SRS levels of our items
+
+    return mSrsLevels;
+}
+
+//==============================================================================
+
+const QVector<uint> & ItemColumns::unlockedDates() const
+{
+    // Return the unlocked dates of our items
+
+    return mUnlockedDates;
+}
+
+//==============================================================================
+
+const QVector<uint> & ItemColumns::availableDates() const
+{
+    // Return the available dates of our items
+
+    return mAvailableDates;
+}
+
+//==============================================================================
+
+const QVector<int> & ItemColumns::correct() const
+{
+    // Return the numbers of correct answers of our items
+
+    return mCorrect;
+}
+
+//==============================================================================
+
+const QVector<int> & ItemColumns::incorrect() const
+{
+    // Return the numbers of incorrect answers of our items
+
+    return mIncorrect;
+}
+
+//==============================================================================
+
+const QVector<QChar> & ItemColumns::characters() const
+{
+    // Return the (Kanji) characters of our items
+
+    return mCharacters;
+}
+
+//==============================================================================
+
+const QVector<QString> & ItemColumns::srs() const
+{
+    // Return the SRS of our items
+
+    return mSrs;
+}
+
+//==============================================================================
+
+void ItemColumns::reserve(int pSize)
+{
+    // Reserve space for the given number of items
+
+    mTypes.reserve(pSize);
+    mLevels.reserve(pSize);
+    mSrsLevels.reserve(pSize);
+    mUnlockedDates.reserve(pSize);
+    mAvailableDates.reserve(pSize);
+    mCorrect.reserve(pSize);
+    mIncorrect.reserve(pSize);
+    mCharacters.reserve(pSize);
+    mSrs.reserve(pSize);
+}
+
+//==============================================================================
+
+void ItemColumns::add(ItemType pType, const Item &pItem,
+                      const UserSpecific &pUserSpecific, int pCorrect,
+                      int pIncorrect, QChar pCharacter)
+{
+    // Add an item
+
+    mTypes << pType;
+    mLevels << pItem.level();
+    mSrsLevels << pUserSpecific.srsNumeric();
+    mUnlockedDates << pUserSpecific.unlockedDate();
+    mAvailableDates << pUserSpecific.availableDate();
+    mCorrect << pCorrect;
+    mIncorrect << pIncorrect;
+    mCharacters << pCharacter;
+    mSrs << pUserSpecific.srs();
+}
+
+//==============================================================================
+
+const User & Snapshot::user() const
+{
+    // Return our user
+
+    return mUser;
+}
+
+//==============================================================================
+
+const StudyQueue & Snapshot::studyQueue() const
+{
+    // Return our study queue
+
+    return mStudyQueue;
+}
+
+//==============================================================================
+
+const LevelProgression & Snapshot::levelProgression() const
+{
+    // Return our level progression
+
+    return mLevelProgression;
+}
+
+//==============================================================================
+
+const SrsDistribution & Snapshot::srsDistribution() const
+{
+    // Return our SRS distribution
+
+    return mSrsDistribution;
+}
+
+//==============================================================================
+
+const Radicals & Snapshot::radicals() const
+{
+    // Return our list of radicals
+
+    return mRadicals;
+}
+
+//==============================================================================
+
+const Kanjis & Snapshot::kanjis() const
+{
+    // Return our list of Kanji
+
+    return mKanjis;
+}
+
+//==============================================================================
+
+const Vocabularies & Snapshot::vocabularies() const
+{
+    // Return our list of vocabulary
+
+    return mVocabularies;
+}
+
+//==============================================================================
+
+const ItemColumns & Snapshot::itemColumns() const
+{
+    // Return our items, column by column
+
+    return mItemColumns;
+}
+
+//==============================================================================
+
+WaniKani::WaniKani() :
+    mSnapshot(new Snapshot()),
+    mNetworkAccessManager(nullptr),
+    mV2Tokens(V2RateLimit),
+    mV2RateLimitRemaining(V2RateLimit)
+{
+    mElapsedTimer.start();
+
+    // Retrieve the subjects we have cached
+
+    loadSubjects();
+
+    // Use a small thread pool to decode our items, since their responses are
+    // independent of one another
+
+    mThreadPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), 3));
+
+    // Live in our own thread, so that retrieving and processing our data never
+    // gets in the way of our GUI thread
+    // Note: we must be stopped from our GUI thread, hence we connect to
+    //       aboutToQuit() directly...
+
+    moveToThread(&mThread);
+
+    connect(&mThread, &QThread::started,
+            this, &WaniKani::started);
+
+    connect(qApp, &QCoreApplication::aboutToQuit,
+            this, &WaniKani::stop, Qt::DirectConnection);
+
+    mThread.start();
+}
+
+//==============================================================================
+
+WaniKani::~WaniKani()
+{
+    // Stop ourselves
+
+    stop();
+}
+
+//==============================================================================
+
+void WaniKani::started()
+{
+    // Create our network access manager, now that we are in our own thread, and
+    // make sure that it gets deleted in it
+
+    mNetworkAccessManager = new QNetworkAccessManager(this);
+
+    connect(&mThread, &QThread::finished,
+            mNetworkAccessManager, &QNetworkAccessManager::deleteLater);
+}
+
+//==============================================================================
+
+void WaniKani::stop()
+{
+    // Stop our thread, if needed
+
+    if (mThread.isRunning()) {
+        mThread.quit();
+        mThread.wait();
+    }
+}
+
+//==============================================================================
+
+void WaniKani::setApiKeyAndToken(const QString &pApiKey,
+                                 const QString &pApiToken)
+{
+    // Set our API key and token, in our own thread
+
+    QMetaObject::invokeMethod(this, "doSetApiKeyAndToken",
+                              Q_ARG(QString, pApiKey),
+                              Q_ARG(QString, pApiToken));
+}
+
+//==============================================================================
+
+void WaniKani::doSetApiKeyAndToken(const QString &pApiKey,
+                                   const QString &pApiToken)
+{
+    // Set our API key and token, cancelling our in-flight update (if any) if
+    // they have changed, and update our information
+
+    if (pApiKey.compare(mApiKey) || pApiToken.compare(mApiToken)) {
+        cancel();
+
+        mUser.reset();
+
+        mAssignments.clear();
+        mAssignmentsUpdatedAt = QString();
+
+        mReviewStatistics.clear();
+        mReviewStatisticsUpdatedAt = QString();
+
+        mV2RateLimitRemaining = V2RateLimit;
+        mV2RateLimitReset = 0;
+
+        for (auto &fetchTime : mFetchTimes) {
+            fetchTime = 0;
+        }
+
+        for (auto &validResponse : mValidResponses) {
+            validResponse = false;
+        }
+
+        for (auto &responseDigest : mResponseDigests) {
+            responseDigest = QByteArray();
+        }
+    }
+
+    mApiKey = pApiKey;
+    mApiToken = pApiToken;
+
+    preconnect();
+    update();
+}
+
+//==============================================================================
+
+void WaniKani::preconnect()
+{
+    // Pre-connect to the WaniKani hosts we are going to need, so that our next
+    // requests don't have to wait for a TLS handshake
+    // Note: we ask for HTTP/2 to be negotiated, so that all of our requests to
+    //       a given host can then be multiplexed over that one connection...
+
+    for (const auto &host : QStringList() << (mApiKey.isEmpty()?QString():WaniKaniHost)
+                                          << (mApiToken.isEmpty()?QString():WaniKaniApiHost)) {
+        if (!host.isEmpty()) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 13, 0)
+            QSslConfiguration hostSslConfiguration = sslConfiguration(host);
+
+            hostSslConfiguration.setAllowedNextProtocols(QList<QByteArray>() << QSslConfiguration::ALPNProtocolHTTP2
+                                                                             << QSslConfiguration::NextProtocolHttp1_1);
+
+            mNetworkAccessManager->connectToHostEncrypted(host, 443, hostSslConfiguration);
+#else
+            mNetworkAccessManager->connectToHostEncrypted(host);
+#endif
+        }
+    }
+}
+
+//==============================================================================
+
+QSslConfiguration WaniKani::sslConfiguration(const QString &pHost) const
+{
+    // Return an SSL configuration for the given host that allows for TLS
+    // sessions to be resumed, using the session ticket we got for that host,
+    // if any
+
+    QSslConfiguration res = QSslConfiguration::defaultConfiguration();
+
+    res.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+    res.setSessionTicket(mSessionTickets.value(pHost));
+
+    return res;
+}
+
+//==============================================================================
+
+QNetworkReply * WaniKani::networkReply(QNetworkRequest &pNetworkRequest)
+{
+    // Send the given request, allowing for HTTP/2 to be used and for a TLS
+    // session to be resumed, and keep track of when we sent it and of when its
+    // connection got encrypted (if it needed a new connection), so that we can
+    // tell apart handshake and transfer times
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    pNetworkRequest.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+#else
+    pNetworkRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
+
+    QSslConfiguration requestSslConfiguration = sslConfiguration(pNetworkRequest.url().host());
+
+    pNetworkRequest.setSslConfiguration(requestSslConfiguration);
+
+    QNetworkReply *res = mNetworkAccessManager->get(pNetworkRequest);
+
+    res->setProperty(GenerationProperty, mGeneration);
+    res->setProperty(StartTimeProperty, mElapsedTimer.elapsed());
+    res->setProperty(SessionTicketProperty, requestSslConfiguration.sessionTicket());
+
+    connect(res, &QNetworkReply::encrypted,
+            this, &WaniKani::networkReplyEncrypted);
+
+    mNetworkReplies << res;
+
+    return res;
+}
+
+//==============================================================================
+
+bool WaniKani::staleNetworkReply(QNetworkReply *pNetworkReply)
+{
+    // Check whether the given network reply belongs to our current generation
+    // of requests and, if not, discard it
+
+    if (pNetworkReply->property(GenerationProperty).toULongLong() != mGeneration) {
+        pNetworkReply->deleteLater();
+
+        return true;
+    }
+
+    mNetworkReplies.removeOne(pNetworkReply);
+
+    return false;
+}
+
+//==============================================================================
+
+bool WaniKani::updating() const
+{
+    // Return whether we are updating, i.e. whether we are waiting for some
+    // network replies or still have some v2 requests to send
+
+    return !mNetworkReplies.isEmpty() || !mV2Requests.isEmpty();
+}
+
+//==============================================================================
+
+void WaniKani::cancel()
+{
+    // Cancel our in-flight update, if any, by moving to a new generation of
+    // requests, dropping our queued v2 requests and aborting our in-flight
+    // network replies, which will then be discarded
+    // Note: we always move to a new generation of requests, so that no reply
+    //       that was sent before we got cancelled (e.g. using an old API key)
+    //       can ever be mistaken for one of our new replies...
+
+    ++mGeneration;
+
+    mForcedUpdatePending = false;
+
+    if (!updating()) {
+        return;
+    }
+
+    Metrics::instance()->add(Metrics::UpdatesCancelled);
+
+    mV2Requests.clear();
+    mV2NetworkReplies.clear();
+
+    Metrics::instance()->set(Metrics::V2QueueDepth, 0);
+
+    mRadicalsFuture = QFuture<ItemsResponse<Radicals>>();
+    mKanjisFuture = QFuture<ItemsResponse<Kanjis>>();
+    mVocabulariesFuture = QFuture<ItemsResponse<Vocabularies>>();
+
+    QList<QNetworkReply *> networkReplies = mNetworkReplies;
+
+    mNetworkReplies.clear();
+
+    for (auto networkReply : networkReplies) {
+        networkReply->abort();
+    }
+}
+
+//==============================================================================
+
+void WaniKani::networkReplyEncrypted()
+{
+    // Keep track of when our network reply got encrypted
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    networkReply->setProperty(EncryptedTimeProperty, mElapsedTimer.elapsed());
+
+    // Keep track of whether our handshake resumed our TLS session with our
+    // host, i.e. whether our connection ended up with the session ticket we
+    // offered, and of the session ticket we now have for our host, so that we
+    // can use it for an abbreviated handshake the next time we need a new
+    // connection to that host
+    // Note: Qt doesn't tell us whether a session was actually resumed and a
+    //       server may issue a new ticket when resuming a session (e.g. with
+    //       TLS 1.3 or ticket rotation), in which case we account for a full
+    //       handshake, so our resumption rate is a lower bound. Also, a
+    //       session ticket is a secret, so we only ever keep our session
+    //       tickets in memory...
+
+    QString host = networkReply->url().host();
+    QByteArray offeredSessionTicket = networkReply->property(SessionTicketProperty).toByteArray();
+    QByteArray sessionTicket = networkReply->sslConfiguration().sessionTicket();
+
+    Metrics::instance()->addHandshake((host == WaniKaniApiHost)?Metrics::V2Host:Metrics::V1Host,
+                                      !offeredSessionTicket.isEmpty() && (sessionTicket == offeredSessionTicket));
+
+    if (!sessionTicket.isEmpty()) {
+        mSessionTickets.insert(host, sessionTicket);
+    }
+}
+
+//==============================================================================
+
+QNetworkReply * WaniKani::waniKaniNetworkReply(const QString &pRequest)
+{
+    // Send a request to WaniKani, asking for its response to be compressed, and
+    // then convert its response to a JSON document, if possible and after
+    // having uncompressed it
+
+    QNetworkRequest networkRequest(QString("https://%1/api/v1.4/user/%2/%3").arg(WaniKaniHost, mApiKey, pRequest));
+
+    networkRequest.setRawHeader("Accept-Encoding", "gzip");
+
+    return networkReply(networkRequest);
+}
+
+//==============================================================================
+
+QNetworkReply * WaniKani::waniKaniV2NetworkReply(const QString &pRequest)
+{
+    // Send a request to WaniKani, asking for its response to be compressed, and
+    // then convert its response to a JSON document, if possible and after
+    // having uncompressed it
+
+    QNetworkRequest networkRequest(QString("https://%1/v2/%2").arg(WaniKaniApiHost, pRequest));
+
+    networkRequest.setRawHeader("Accept-Encoding", "gzip");
+    networkRequest.setRawHeader("Wanikani-Revision", "20170710");
+    networkRequest.setRawHeader("Authorization", QString("Bearer %1").arg(mApiToken).toUtf8());
+
+    return networkReply(networkRequest);
+}
+
+//==============================================================================
+
+void WaniKani::requestV2(const QString &pRequest, RequestPriority pPriority,
+                         ReplySlot pSlot)
+{
+    // Queue the given v2 request after the requests that have the same or a
+    // higher priority, and send as many of our queued requests as our rate
+    // limit allows, unless we are already waiting for our tokens to be
+    // replenished
+
+    int i = 0;
+
+    while ((i < mV2Requests.count()) && (mV2Requests[i].priority <= pPriority)) {
+        ++i;
+    }
+
+    mV2Requests.insert(i, { pRequest, pPriority, pSlot, mElapsedTimer.elapsed() });
+
+    Metrics::instance()->set(Metrics::V2QueueDepth, mV2Requests.count());
+
+    if (!mV2RequestsScheduled) {
+        sendV2Requests();
+    }
+}
+
+//==============================================================================
+
+void WaniKani::sendV2Requests()
+{
+    // Send our queued v2 requests, highest priority first, for as long as we
+    // have some tokens left and the current rate limit window of the v2 API
+    // allows us to, and then wait for that to be the case again
+    // Note: our tokens are replenished at the rate allowed by the v2 API, up to
+    //       its rate limit, while what is left in its current window is kept
+    //       in sync with its RateLimit-Remaining and RateLimit-Reset headers
+    //       (see v2Reply())...
+
+    mV2RequestsScheduled = false;
+
+    qint64 elapsed = mElapsedTimer.elapsed();
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    mV2Tokens = qMin(double(V2RateLimit), mV2Tokens+V2TokensPerMs*(elapsed-mV2TokensTime));
+    mV2TokensTime = elapsed;
+
+    if (now >= mV2RateLimitReset) {
+        mV2RateLimitRemaining = V2RateLimit;
+    }
+
+    while (!mV2Requests.isEmpty() && (mV2Tokens >= 1.0) && mV2RateLimitRemaining) {
+        V2Request request = mV2Requests.takeFirst();
+
+        mV2Tokens -= 1.0;
+
+        --mV2RateLimitRemaining;
+
+        Metrics::instance()->set(Metrics::V2QueueWaitTime, elapsed-request.queueTime);
+
+        QNetworkReply *networkReply = waniKaniV2NetworkReply(request.request);
+
+        connect(networkReply, &QNetworkReply::finished,
+                this, &WaniKani::v2Reply);
+
+        mV2NetworkReplies.insert(networkReply, request);
+    }
+
+    Metrics::instance()->set(Metrics::V2QueueDepth, mV2Requests.count());
+
+    if (!mV2Requests.isEmpty()) {
+        // Wait for our next token and, if needed, for the current window to be
+        // reset
+
+        mV2RequestsScheduled = true;
+
+        Metrics::instance()->add(Metrics::V2RequestsThrottled);
+
+        qint64 delay = (mV2Tokens < 1.0)?qint64(ceil((1.0-mV2Tokens)/V2TokensPerMs)):0;
+
+        if (!mV2RateLimitRemaining) {
+            delay = qMax(delay, 1000*qMax(qint64(1), mV2RateLimitReset-now));
+        }
+
+        QTimer::singleShot(int(delay), this, &WaniKani::sendV2Requests);
+    }
+}
+
+//==============================================================================
+
+void WaniKani::v2Reply()
+{
+    // Keep track of the rate limit of the v2 API, as reported by the server
+    // Note: the rate limit of a stale reply may be that of an old API token,
+    //       so we ignore it. Also, our replies may come back in any order, so
+    //       we only trust the lowest number of remaining requests that we have
+    //       seen for the current window, ignoring replies from older windows...
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+    V2Request request = mV2NetworkReplies.take(networkReply);
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    if (networkReply->hasRawHeader("RateLimit-Remaining")) {
+        int rateLimitRemaining = networkReply->rawHeader("RateLimit-Remaining").toInt();
+        qint64 rateLimitReset = networkReply->rawHeader("RateLimit-Reset").toLongLong();
+
+        if (rateLimitReset > mV2RateLimitReset) {
+            mV2RateLimitRemaining = rateLimitRemaining;
+            mV2RateLimitReset = rateLimitReset;
+        } else if (rateLimitReset == mV2RateLimitReset) {
+            mV2RateLimitRemaining = qMin(mV2RateLimitRemaining, rateLimitRemaining);
+        }
+    }
+
+    // Requeue our request if we have been rate limited, making sure that we
+    // don't resend it before our tokens have been replenished, or let our
+    // request's slot handle the reply
+    // Note: our request's slot is called from here, so sender() is still our
+    //       network reply from its point of view...
+
+    if (networkReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 429) {
+        Metrics::instance()->add(Metrics::V2RequestsRateLimited);
+
+        networkReply->deleteLater();
+
+        mV2RateLimitRemaining = 0;
+        mV2RateLimitReset = qMax(mV2RateLimitReset, QDateTime::currentSecsSinceEpoch()+1);
+
+        requestV2(request.request, request.priority, request.slot);
+    } else {
+        (this->*request.slot)();
+    }
+}
+
+//==============================================================================
+
+QString WaniKani::updatedAfterRequest(const QString &pRequest,
+                                      const QString &pUpdatedAt)
+{
+    // Return the given v2 request, restricted to the resources that have been
+    // updated after the given time, if any
+
+    if (pUpdatedAt.isEmpty()) {
+        return pRequest;
+    }
+
+    return QString("%1?updated_after=%2").arg(pRequest, QString(QUrl::toPercentEncoding(pUpdatedAt)));
+}
+
+//==============================================================================
+
+QString WaniKani::nextPageRequest(const QVariantMap &pCollectionMap)
+{
+    // Return the v2 request for the next page of the given collection, if any
+
+    QString nextUrl = pCollectionMap["pages"].toMap()["next_url"].toString();
+
+    if (nextUrl.isEmpty()) {
+        return QString();
+    }
+
+    return nextUrl.remove(QString("https://%1/v2/").arg(WaniKaniApiHost));
+}
+
+//==============================================================================
+
+bool WaniKani::waniKaniResponse(QNetworkReply *pNetworkReply,
+                                Metrics::Endpoint pEndpoint,
+                                QByteArray &pResponse)
+{
+    // Retrieve the (compressed) response from the given network reply and
+    // return whether it is a new one, i.e. it is not the same as the one we
+    // previously got for the given endpoint
+    // Note: a new response is only valid once it has been processed (see
+    //       validResponse())...
+
+    if (pNetworkReply->error() == QNetworkReply::NoError) {
+        pResponse = pNetworkReply->readAll();
+    }
+
+    qint64 now = mElapsedTimer.elapsed();
+    qint64 startTime = pNetworkReply->property(StartTimeProperty).toLongLong();
+    QVariant encryptedTime = pNetworkReply->property(EncryptedTimeProperty);
+    qint64 handshakeTime = encryptedTime.isValid()?encryptedTime.toLongLong()-startTime:0;
+
+    Metrics::instance()->addFetchLatency(pEndpoint, now-startTime);
+    Metrics::instance()->setHandshakeAndTransferTimes(pEndpoint, handshakeTime, now-startTime-handshakeTime);
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    if (pNetworkReply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool()) {
+#else
+    if (pNetworkReply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool()) {
+#endif
+        Metrics::instance()->add(Metrics::Http2Replies);
+    }
+
+    pNetworkReply->deleteLater();
+
+    if (pResponse.isEmpty()) {
+        mValidResponses[pEndpoint] = false;
+
+        return false;
+    } else {
+        // Check whether the response is the same as the previous one, based on
+        // the CRC32 and ISIZE of the uncompressed data (i.e. the last 8 bytes
+        // of a gzip member) and on the CRC32 of the compressed data, in which
+        // case there is no need to uncompress and parse it again
+
+        enum {
+            GzipHeaderSize = 10,
+            GzipTrailerSize = 8
+        };
+
+        QByteArray digest = QByteArray();
+
+        if (   (pResponse.size() > GzipHeaderSize+GzipTrailerSize)
+            && (uchar(pResponse.at(0)) == 0x1f) && (uchar(pResponse.at(1)) == 0x8b)) {
+            uLong responseCrc = crc32(0, reinterpret_cast<const Bytef *>(pResponse.constData()), uInt(pResponse.size()));
+
+            digest = pResponse.right(GzipTrailerSize)+QByteArray::number(quint64(responseCrc));
+
+            if (digest == mResponseDigests[pEndpoint]) {
+                const uchar *trailer = reinterpret_cast<const uchar *>(pResponse.constData()+pResponse.size()-GzipTrailerSize);
+                qint64 inflatedSize = trailer[4] | (trailer[5] << 8) | (trailer[6] << 16) | (quint32(trailer[7]) << 24);
+
+                Metrics::instance()->addDownload(pEndpoint, pResponse.size(), inflatedSize);
+                Metrics::instance()->add(Metrics::ResponsesUnchanged);
+
+                mFetchTimes[pEndpoint] = QDateTime::currentSecsSinceEpoch();
+                mValidResponses[pEndpoint] = true;
+
+                return false;
+            }
+        }
+
+        mResponseDigests[pEndpoint] = digest;
+        mValidResponses[pEndpoint] = false;
+
+        return true;
+    }
+}
+
+//==============================================================================
+
+QJsonDocument WaniKani::jsonDocument(Metrics::Endpoint pEndpoint,
+                                     const QByteArray &pResponse)
+{
+    // Uncompress and parse the given response
+    // Note: this may be called from our thread pool, so we must not use any of
+    //       our members here...
+
+    QByteArray json = Inflater::inflated(pResponse);
+
+    Metrics::instance()->addDownload(pEndpoint, pResponse.size(), json.size());
+
+    // Convert the response to a JSON document
+
+    QElapsedTimer parseTimer;
+
+    parseTimer.start();
+
+    QJsonDocument res = QJsonDocument::fromJson(json);
+
+    Metrics::instance()->addParseTime(pEndpoint, parseTimer.nsecsElapsed()/1000);
+
+    if (   !validJsonDocument(res)
+        || res.object().toVariantMap()["error"].toMap().count()) {
+        return QJsonDocument();
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+bool WaniKani::validResponse(Metrics::Endpoint pEndpoint, bool pValid)
+{
+    // Keep track of whether the new response for the given endpoint is valid
+    // Note: we forget about the digest of an invalid response, so that an
+    //       identical response doesn't get mistaken for an unchanged valid
+    //       one (see waniKaniResponse())...
+
+    mValidResponses[pEndpoint] = pValid;
+
+    if (pValid) {
+        mFetchTimes[pEndpoint] = QDateTime::currentSecsSinceEpoch();
+    } else {
+        mResponseDigests[pEndpoint] = QByteArray();
+    }
+
+    return pValid;
+}
+
+//==============================================================================
+
+bool WaniKani::waniKaniJsonResponse(QNetworkReply *pNetworkReply,
+                                    Metrics::Endpoint pEndpoint,
+                                    QJsonDocument &pJsonDocument)
+{
+    // Retrieve the JSON document from the given network reply and return
+    // whether it is a new valid one
+    // Note: we don't keep the JSON document, only whether the response for the
+    //       given endpoint is valid, so that the (possibly big) document can be
+    //       released as soon as it has been processed...
+
+    QByteArray response = QByteArray();
+
+    if (!waniKaniResponse(pNetworkReply, pEndpoint, response)) {
+        return false;
+    }
+
+    pJsonDocument = jsonDocument(pEndpoint, response);
+
+    return validResponse(pEndpoint, !pJsonDocument.isNull());
+}
+
+//==============================================================================
+
+bool WaniKani::validJsonDocument(const QJsonDocument &pJsonDocument)
+{
+    // Return whether the given JSON document is valid
+
+    return !pJsonDocument.isNull() && !pJsonDocument.object().contains("error");
+}
+
+//==============================================================================
+
+uint WaniKani::epochTime(const QVariant &pDateTime)
+{
+    // Return the given (v2) date and time as a number of seconds since epoch,
+    // or zero if there is no date and time
+
+    QDateTime dateTime = QDateTime::fromString(pDateTime.toString(), Qt::ISODate);
+
+    return dateTime.isValid()?uint(dateTime.toSecsSinceEpoch()):0;
+}
+
+//==============================================================================
+
+void WaniKani::userReply()
+{
+    // Retrieve, if available, the user's information
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    QJsonDocument jsonDocument;
+
+    if (waniKaniJsonResponse(networkReply, Metrics::UserEndpoint, jsonDocument)) {
+        mChanged = true;
+
+        QVariantMap userResponseMap = jsonDocument.object().toVariantMap()["data"].toMap();
+
+        mUser.mHasData = true;
+        mUser.mCurrentVacationStartedAt = QDateTime::fromString(userResponseMap["current_vacation_started_at"].toString(), Qt::ISODate);
+        mUser.mLevel = userResponseMap["level"].toInt();
+        mUser.mProfileUrl = userResponseMap["profile_url"].toString();
+        mUser.mUserName = userResponseMap["username"].toString();
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+void WaniKani::studyQueueReply()
+{
+    // Retrieve, if available, some of the user's information, the user's study
+    // queu and the user's gravatar
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    bool staleEndpoints = networkReply->property(StaleEndpointsProperty).toBool();
+    bool studyQueueChanged = false;
+
+    QJsonDocument jsonDocument;
+
+    if (waniKaniJsonResponse(networkReply, Metrics::StudyQueueEndpoint, jsonDocument)) {
+        mChanged = true;
+
+        QVariantMap studyQueueMap = jsonDocument.object().toVariantMap()["requested_information"].toMap();
+        int lessonsAvailable = studyQueueMap["lessons_available"].toInt();
+        int reviewsAvailable = studyQueueMap["reviews_available"].toInt();
+
+        studyQueueChanged =    (lessonsAvailable != mReportedStudyQueue.mLessonsAvailable)
+                            || (reviewsAvailable != mReportedStudyQueue.mReviewsAvailable);
+
+        mReportedStudyQueue.mLessonsAvailable = lessonsAvailable;
+        mReportedStudyQueue.mReviewsAvailable = reviewsAvailable;
+        mReportedStudyQueue.mNextReviewDate = studyQueueMap["next_review_date"].toUInt();
+        mReportedStudyQueue.mReviewsAvailableNextHour = studyQueueMap["reviews_available_next_hour"].toInt();
+        mReportedStudyQueue.mReviewsAvailableNextDay = studyQueueMap["reviews_available_next_day"].toInt();
+
+        mStudyQueue = mReportedStudyQueue;
+    }
+
+    // Retrieve our other endpoints, if they are stale
+
+    if (staleEndpoints) {
+        requestStaleEndpoints(studyQueueChanged);
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+void WaniKani::levelProgressionReply()
+{
+    // Retrieve, if available, the user's level progression
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    QJsonDocument jsonDocument;
+
+    if (waniKaniJsonResponse(networkReply, Metrics::LevelProgressionEndpoint, jsonDocument)) {
+        mChanged = true;
+
+        QVariantMap levelProgressionResponseMap = jsonDocument.object().toVariantMap()["requested_information"].toMap();
+
+        mReportedLevelProgression.mRadicalsProgress = levelProgressionResponseMap["radicals_progress"].toInt();
+        mReportedLevelProgression.mRadicalsTotal = levelProgressionResponseMap["radicals_total"].toInt();
+        mReportedLevelProgression.mKanjiProgress = levelProgressionResponseMap["kanji_progress"].toInt();
+        mReportedLevelProgression.mKanjiTotal = levelProgressionResponseMap["kanji_total"].toInt();
+
+        mLevelProgression = mReportedLevelProgression;
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+void WaniKani::srsDistributionReply()
+{
+    // Retrieve, if available, the user's SRS distribution
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    QJsonDocument jsonDocument;
+
+    if (waniKaniJsonResponse(networkReply, Metrics::SrsDistributionEndpoint, jsonDocument)) {
+        mChanged = true;
+
+        QVariantMap srsDistributionMap = jsonDocument.object().toVariantMap()["requested_information"].toMap();
+
+        updateSrsDistribution("Apprentice", srsDistributionMap["apprentice"].toMap(), mReportedSrsDistribution.mApprentice);
+        updateSrsDistribution("Guru", srsDistributionMap["guru"].toMap(), mReportedSrsDistribution.mGuru);
+        updateSrsDistribution("Master", srsDistributionMap["master"].toMap(), mReportedSrsDistribution.mMaster);
+        updateSrsDistribution("Enlightened", srsDistributionMap["enlighten"].toMap(), mReportedSrsDistribution.mEnlightened);
+        updateSrsDistribution("Burned", srsDistributionMap["burned"].toMap(), mReportedSrsDistribution.mBurned);
+
+        mSrsDistribution = mReportedSrsDistribution;
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+ItemsResponse<Radicals> WaniKani::parseRadicals(const QByteArray &pResponse)
+{
+    // Uncompress, parse and decode the given response
+    // Note: this is called from our thread pool, so we must not use any of our
+    //       members here...
+
+    ItemsResponse<Radicals> res;
+    QJsonDocument document = jsonDocument(Metrics::RadicalsEndpoint, pResponse);
+
+    if (document.isNull()) {
+        return res;
+    }
+
+    QElapsedTimer parseTimer;
+    std::shared_ptr<StringArena> stringArena(new StringArena());
+
+    parseTimer.start();
+
+    for (const auto &radicalInformation : document.object().toVariantMap()["requested_information"].toList()) {
+        QVariantMap radicalInformationMap = radicalInformation.toMap();
+        Radical radical;
+
+        radical.mCharacters = stringArena->add(radicalInformationMap["character"].toString());
+        radical.mMeaning = stringArena->add(radicalInformationMap["meaning"].toString());
+        radical.mImage = stringArena->add(radicalInformationMap["image"].toString());
+        radical.mLevel = radicalInformationMap["level"].toInt();
+
+        QVariantMap radicalUserSpecificInformationMap = radicalInformationMap["user_specific"].toMap();
+
+        radical.mUserSpecific.mSrs = radicalUserSpecificInformationMap["srs"].toString();
+        radical.mUserSpecific.mSrsNumeric = radicalUserSpecificInformationMap["srs_numeric"].toInt();
+        radical.mUserSpecific.mUnlockedDate = radicalUserSpecificInformationMap["unlocked_date"].toUInt();
+        radical.mUserSpecific.mAvailableDate = radicalUserSpecificInformationMap["burned"].toBool()?0:radicalUserSpecificInformationMap["available_date"].toUInt();
+        radical.mUserSpecific.mBurned = radicalUserSpecificInformationMap["burned"].toBool();
+        radical.mUserSpecific.mBurnedDate = radicalUserSpecificInformationMap["burned_date"].toUInt();
+        radical.mUserSpecific.mMeaningCorrect = radicalUserSpecificInformationMap["meaning_correct"].toInt();
+        radical.mUserSpecific.mMeaningIncorrect = radicalUserSpecificInformationMap["meaning_incorrect"].toInt();
+        radical.mUserSpecific.mMeaningMaxStreak = radicalUserSpecificInformationMap["meaning_max_streak"].toInt();
+        radical.mUserSpecific.mMeaningCurrentStreak = radicalUserSpecificInformationMap["meaning_current_streak"].toInt();
+        radical.mUserSpecific.mReadingCorrect = radicalUserSpecificInformationMap["reading_correct"].toInt();
+        radical.mUserSpecific.mReadingIncorrect = radicalUserSpecificInformationMap["reading_incorrect"].toInt();
+        radical.mUserSpecific.mReadingMaxStreak = radicalUserSpecificInformationMap["reading_max_streak"].toInt();
+        radical.mUserSpecific.mReadingCurrentStreak = radicalUserSpecificInformationMap["reading_current_streak"].toInt();
+        radical.mUserSpecific.mMeaningNote = stringArena->add(radicalUserSpecificInformationMap["meaning_note"].toString());
+        radical.mUserSpecific.mUserSynonyms = stringArena->add(radicalUserSpecificInformationMap["user_synonyms"].toString());
+
+        res.items << radical;
+    }
+
+    Metrics::instance()->addParseTime(Metrics::RadicalsEndpoint, parseTimer.nsecsElapsed()/1000);
+    Metrics::instance()->setNbOfItems(Metrics::RadicalsEndpoint, res.items.count());
+
+    stringArena->squeeze();
+
+    res.valid = true;
+
+    return res;
+}
+
+//==============================================================================
+
+void WaniKani::radicalsReply()
+{
+    // Retrieve, if available, the radicals and their information, which we
+    // uncompress, parse and decode using our thread pool (see
+    // checkNbOfReplies())
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    QByteArray response = QByteArray();
+
+    if (waniKaniResponse(networkReply, Metrics::RadicalsEndpoint, response)) {
+        mRadicalsFuture = QtConcurrent::run(&mThreadPool, &WaniKani::parseRadicals, response);
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+ItemsResponse<Kanjis> WaniKani::parseKanjis(const QByteArray &pResponse)
+{
+    // Uncompress, parse and decode the given response
+    // Note: this is called from our thread pool, so we must not use any of our
+    //       members here...
+
+    ItemsResponse<Kanjis> res;
+    QJsonDocument document = jsonDocument(Metrics::KanjiEndpoint, pResponse);
+
+    if (document.isNull()) {
+        return res;
+    }
+
+    QElapsedTimer parseTimer;
+    std::shared_ptr<StringArena> stringArena(new StringArena());
+
+    parseTimer.start();
+
+    for (const auto &kanjiInformation : document.object().toVariantMap()["requested_information"].toList()) {
+        QVariantMap kanjiInformationMap = kanjiInformation.toMap();
+        Kanji kanji;
+
+        kanji.mCharacters = stringArena->add(kanjiInformationMap["character"].toString());
+        kanji.mMeaning = stringArena->add(kanjiInformationMap["meaning"].toString());
+        kanji.mOnyomi = stringArena->add(kanjiInformationMap["onyomi"].toString());
+        kanji.mKunyomi = stringArena->add(kanjiInformationMap["kunyomi"].toString());
+        kanji.mNanori = stringArena->add(kanjiInformationMap["nanori"].toString());
+        kanji.mImportantReading = stringArena->add(kanjiInformationMap["important_reading"].toString());
+        kanji.mLevel = kanjiInformationMap["level"].toInt();
+
+        QVariantMap kanjiUserSpecificInformationMap = kanjiInformationMap["user_specific"].toMap();
+
+        kanji.mUserSpecific.mSrs = kanjiUserSpecificInformationMap["srs"].toString();
+        kanji.mUserSpecific.mSrsNumeric = kanjiUserSpecificInformationMap["srs_numeric"].toInt();
+        kanji.mUserSpecific.mUnlockedDate = kanjiUserSpecificInformationMap["unlocked_date"].toUInt();
+        kanji.mUserSpecific.mAvailableDate = kanjiUserSpecificInformationMap["burned"].toBool()?0:kanjiUserSpecificInformationMap["available_date"].toUInt();
+        kanji.mUserSpecific.mBurned = kanjiUserSpecificInformationMap["burned"].toBool();
+        kanji.mUserSpecific.mBurnedDate = kanjiUserSpecificInformationMap["burned_date"].toUInt();
+        kanji.mUserSpecific.mMeaningCorrect = kanjiUserSpecificInformationMap["meaning_correct"].toInt();
+        kanji.mUserSpecific.mMeaningIncorrect = kanjiUserSpecificInformationMap["meaning_incorrect"].toInt();
+        kanji.mUserSpecific.mMeaningMaxStreak = kanjiUserSpecificInformationMap["meaning_max_streak"].toInt();
+        kanji.mUserSpecific.mMeaningCurrentStreak = kanjiUserSpecificInformationMap["meaning_current_streak"].toInt();
+        kanji.mUserSpecific.mReadingCorrect = kanjiUserSpecificInformationMap["reading_correct"].toInt();
+        kanji.mUserSpecific.mReadingIncorrect = kanjiUserSpecificInformationMap["reading_incorrect"].toInt();
+        kanji.mUserSpecific.mReadingMaxStreak = kanjiUserSpecificInformationMap["reading_max_streak"].toInt();
+        kanji.mUserSpecific.mReadingCurrentStreak = kanjiUserSpecificInformationMap["reading_current_streak"].toInt();
+        kanji.mUserSpecific.mMeaningNote = stringArena->add(kanjiUserSpecificInformationMap["meaning_note"].toString());
+        kanji.mUserSpecific.mUserSynonyms = stringArena->add(kanjiUserSpecificInformationMap["user_synonyms"].toString());
+        kanji.mUserSpecific.mReadingNote = stringArena->add(kanjiUserSpecificInformationMap["reading_note"].toString());
+
+        res.items << kanji;
+    }
+
+    Metrics::instance()->addParseTime(Metrics::KanjiEndpoint, parseTimer.nsecsElapsed()/1000);
+    Metrics::instance()->setNbOfItems(Metrics::KanjiEndpoint, res.items.count());
+
+    stringArena->squeeze();
+
+    res.valid = true;
+
+    return res;
+}
+
+//==============================================================================
+
+void WaniKani::kanjiReply()
+{
+    // Retrieve, if available, the Kanji and their information, which we
+    // uncompress, parse and decode using our thread pool (see
+    // checkNbOfReplies())
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    QByteArray response = QByteArray();
+
+    if (waniKaniResponse(networkReply, Metrics::KanjiEndpoint, response)) {
+        mKanjisFuture = QtConcurrent::run(&mThreadPool, &WaniKani::parseKanjis, response);
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+ItemsResponse<Vocabularies> WaniKani::parseVocabularies(const QByteArray &pResponse)
+{
+    // Uncompress, parse and decode the given response
+    // Note: this is called from our thread pool, so we must not use any of our
+    //       members here...
+
+    ItemsResponse<Vocabularies> res;
+    QJsonDocument document = jsonDocument(Metrics::VocabularyEndpoint, pResponse);
+
+    if (document.isNull()) {
+        return res;
+    }
+
+    QElapsedTimer parseTimer;
+    std::shared_ptr<StringArena> stringArena(new StringArena());
+
+    parseTimer.start();
+
+    for (const auto &vocabularyInformation : document.object().toVariantMap()["requested_information"].toList()) {
+        QVariantMap vocabularyInformationMap = vocabularyInformation.toMap();
+        Vocabulary vocabulary;
+
+        vocabulary.mCharacters = stringArena->add(vocabularyInformationMap["character"].toString());
+        vocabulary.mKana = stringArena->add(vocabularyInformationMap["kana"].toString());
+        vocabulary.mMeaning = stringArena->add(vocabularyInformationMap["meaning"].toString());
+        vocabulary.mLevel = vocabularyInformationMap["level"].toInt();
+
+        QVariantMap vocabularyUserSpecificInformationMap = vocabularyInformationMap["user_specific"].toMap();
+
+        vocabulary.mUserSpecific.mSrs = vocabularyUserSpecificInformationMap["srs"].toString();
+        vocabulary.mUserSpecific.mSrsNumeric = vocabularyUserSpecificInformationMap["srs_numeric"].toInt();
+        vocabulary.mUserSpecific.mUnlockedDate = vocabularyUserSpecificInformationMap["unlocked_date"].toUInt();
+        vocabulary.mUserSpecific.mAvailableDate = vocabularyUserSpecificInformationMap["burned"].toBool()?0:vocabularyUserSpecificInformationMap["available_date"].toUInt();
+        vocabulary.mUserSpecific.mBurned = vocabularyUserSpecificInformationMap["burned"].toBool();
+        vocabulary.mUserSpecific.mBurnedDate = vocabularyUserSpecificInformationMap["burned_date"].toUInt();
+        vocabulary.mUserSpecific.mMeaningCorrect = vocabularyUserSpecificInformationMap["meaning_correct"].toInt();
+        vocabulary.mUserSpecific.mMeaningIncorrect = vocabularyUserSpecificInformationMap["meaning_incorrect"].toInt();
+        vocabulary.mUserSpecific.mMeaningMaxStreak = vocabularyUserSpecificInformationMap["meaning_max_streak"].toInt();
+        vocabulary.mUserSpecific.mMeaningCurrentStreak = vocabularyUserSpecificInformationMap["meaning_current_streak"].toInt();
+        vocabulary.mUserSpecific.mReadingCorrect = vocabularyUserSpecificInformationMap["reading_correct"].toInt();
+        vocabulary.mUserSpecific.mReadingIncorrect = vocabularyUserSpecificInformationMap["reading_incorrect"].toInt();
+        vocabulary.mUserSpecific.mReadingMaxStreak = vocabularyUserSpecificInformationMap["reading_max_streak"].toInt();
+        vocabulary.mUserSpecific.mReadingCurrentStreak = vocabularyUserSpecificInformationMap["reading_current_streak"].toInt();
+        vocabulary.mUserSpecific.mMeaningNote = stringArena->add(vocabularyUserSpecificInformationMap["meaning_note"].toString());
+        vocabulary.mUserSpecific.mUserSynonyms = stringArena->add(vocabularyUserSpecificInformationMap["user_synonyms"].toString());
+        vocabulary.mUserSpecific.mReadingNote = stringArena->add(vocabularyUserSpecificInformationMap["reading_note"].toString());
+
+        res.items << vocabulary;
+    }
+
+    Metrics::instance()->addParseTime(Metrics::VocabularyEndpoint, parseTimer.nsecsElapsed()/1000);
+    Metrics::instance()->setNbOfItems(Metrics::VocabularyEndpoint, res.items.count());
+
+    stringArena->squeeze();
+
+    res.valid = true;
+
+    return res;
+}
+
+//==============================================================================
+
+void WaniKani::vocabularyReply()
+{
+    // Retrieve, if available, the vocabularies and their information, which we
+    // uncompress, parse and decode using our thread pool (see
+    // checkNbOfReplies())
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    QByteArray response = QByteArray();
+
+    if (waniKaniResponse(networkReply, Metrics::VocabularyEndpoint, response)) {
+        mVocabulariesFuture = QtConcurrent::run(&mThreadPool, &WaniKani::parseVocabularies, response);
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+QString WaniKani::subjectsFileName()
+{
+    // Return the name of the file in which we cache our subjects
+
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)+QDir::separator()+"subjects.dat";
+}
+
+//==============================================================================
+
+void WaniKani::loadSubjects()
+{
+    // Retrieve the subjects we have cached, if any and if they are compatible
+    // with us
+    // Note: all the strings of our cached subjects end up in the same string
+    //       arena...
+
+    QFile file(subjectsFileName());
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream >> magic >> version;
+
+    if ((magic != SubjectsFileMagic) || (version != SubjectsFileVersion)) {
+        return;
+    }
+
+    std::shared_ptr<StringArena> stringArena(new StringArena());
+    auto readString = [&]() {
+        QString string;
+
+        stream >> string;
+
+        return stringArena->add(string);
+    };
+    QMap<int, Radical> radicalSubjects;
+    QMap<int, Kanji> kanjiSubjects;
+    QMap<int, Vocabulary> vocabularySubjects;
+    QString subjectsUpdatedAt;
+    int nbOfRadicals = 0;
+    int nbOfKanjis = 0;
+    int nbOfVocabularies = 0;
+
+    stream >> subjectsUpdatedAt;
+
+    stream >> nbOfRadicals;
+
+    for (int i = 0; (i < nbOfRadicals) && (stream.status() == QDataStream::Ok); ++i) {
+        int id = 0;
+        Radical radical;
+
+        stream >> id;
+
+        radical.mCharacters = readString();
+        radical.mMeaning = readString();
+
+        stream >> radical.mLevel;
+
+        radical.mImage = readString();
+
+        radicalSubjects.insert(id, radical);
+    }
+
+    stream >> nbOfKanjis;
+
+    for (int i = 0; (i < nbOfKanjis) && (stream.status() == QDataStream::Ok); ++i) {
+        int id = 0;
+        Kanji kanji;
+
+        stream >> id;
+
+        kanji.mCharacters = readString();
+        kanji.mMeaning = readString();
+
+        stream >> kanji.mLevel;
+
+        kanji.mOnyomi = readString();
+        kanji.mKunyomi = readString();
+        kanji.mNanori = readString();
+        kanji.mImportantReading = readString();
+
+        kanjiSubjects.insert(id, kanji);
+    }
+
+    stream >> nbOfVocabularies;
+
+    for (int i = 0; (i < nbOfVocabularies) && (stream.status() == QDataStream::Ok); ++i) {
+        int id = 0;
+        Vocabulary vocabulary;
+
+        stream >> id;
+
+        vocabulary.mCharacters = readString();
+        vocabulary.mMeaning = readString();
+
+        stream >> vocabulary.mLevel;
+
+        vocabulary.mKana = readString();
+
+        vocabularySubjects.insert(id, vocabulary);
+    }
+
+    // Only use our cached subjects if they could all be read
+
+    if (stream.status() == QDataStream::Ok) {
+        stringArena->squeeze();
+
+        mRadicalSubjects = radicalSubjects;
+        mKanjiSubjects = kanjiSubjects;
+        mVocabularySubjects = vocabularySubjects;
+        mSubjectsUpdatedAt = subjectsUpdatedAt;
+    }
+}
+
+//==============================================================================
+
+bool WaniKani::saveSubjects() const
+{
+    // Cache our subjects, so that we only need to retrieve the subjects that
+    // have been updated since then the next time we are started, and return
+    // whether we could
+
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+
+    QSaveFile file(subjectsFileName());
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << SubjectsFileMagic << SubjectsFileVersion << mSubjectsUpdatedAt;
+
+    stream << mRadicalSubjects.count();
+
+    for (auto radical = mRadicalSubjects.constBegin(), endRadical = mRadicalSubjects.constEnd();
+         radical != endRadical; ++radical) {
+        stream << radical.key() << radical->mCharacters.toString() << radical->mMeaning.toString() << radical->mLevel
+               << radical->mImage.toString();
+    }
+
+    stream << mKanjiSubjects.count();
+
+    for (auto kanji = mKanjiSubjects.constBegin(), endKanji = mKanjiSubjects.constEnd();
+         kanji != endKanji; ++kanji) {
+        stream << kanji.key() << kanji->mCharacters.toString() << kanji->mMeaning.toString() << kanji->mLevel
+               << kanji->mOnyomi.toString() << kanji->mKunyomi.toString() << kanji->mNanori.toString()
+               << kanji->mImportantReading.toString();
+    }
+
+    stream << mVocabularySubjects.count();
+
+    for (auto vocabulary = mVocabularySubjects.constBegin(), endVocabulary = mVocabularySubjects.constEnd();
+         vocabulary != endVocabulary; ++vocabulary) {
+        stream << vocabulary.key() << vocabulary->mCharacters.toString() << vocabulary->mMeaning.toString() << vocabulary->mLevel
+               << vocabulary->mKana.toString();
+    }
+
+    return file.commit();
+}
+
+//==============================================================================
+
+void WaniKani::subjectsReply()
+{
+    // Retrieve, if available, (a page of) the subjects that have been updated
+    // since we last retrieved them, and request the next page, if any, or
+    // cache our subjects, if we have got all of them
+    // Note: a subject is immutable as far as the user is concerned, so we only
+    //       need to retrieve it again if WaniKani updates it...
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    QJsonDocument jsonDocument;
+
+    if (waniKaniJsonResponse(networkReply, Metrics::SubjectsEndpoint, jsonDocument)) {
+        QElapsedTimer parseTimer;
+        std::shared_ptr<StringArena> stringArena(new StringArena());
+
+        parseTimer.start();
+
+        QVariantMap collectionMap = jsonDocument.object().toVariantMap();
+        QVariantList subjects = collectionMap["data"].toList();
+
+        for (const auto &subject : subjects) {
+            QVariantMap subjectMap = subject.toMap();
+            QVariantMap subjectDataMap = subjectMap["data"].toMap();
+            int id = subjectMap["id"].toInt();
+            QString object = subjectMap["object"].toString();
+
+            mRadicalSubjects.remove(id);
+            mKanjiSubjects.remove(id);
+            mVocabularySubjects.remove(id);
+
+            if (!subjectDataMap["hidden_at"].toString().isEmpty()) {
+                continue;
+            }
+
+            QString characters = subjectDataMap["characters"].toString();
+            QStringList meanings = QStringList();
+
+            for (const auto &meaning : subjectDataMap["meanings"].toList()) {
+                QVariantMap meaningMap = meaning.toMap();
+
+                if (meaningMap["primary"].toBool()) {
+                    meanings.prepend(meaningMap["meaning"].toString());
+                } else if (meaningMap["accepted_answer"].toBool()) {
+                    meanings << meaningMap["meaning"].toString();
+                }
+            }
+
+            if (!object.compare("radical")) {
+                Radical radical;
+
+                radical.mCharacters = stringArena->add(characters);
+                radical.mMeaning = stringArena->add(meanings.join(", "));
+                radical.mLevel = subjectDataMap["level"].toInt();
+
+                for (const auto &characterImage : subjectDataMap["character_images"].toList()) {
+                    QVariantMap characterImageMap = characterImage.toMap();
+
+                    if (!characterImageMap["content_type"].toString().compare("image/png")) {
+                        radical.mImage = stringArena->add(characterImageMap["url"].toString());
+
+                        break;
+                    }
+                }
+
+                mRadicalSubjects.insert(id, radical);
+            } else if (!object.compare("kanji")) {
+                Kanji kanji;
+                QStringList onyomi = QStringList();
+                QStringList kunyomi = QStringList();
+                QStringList nanori = QStringList();
+
+                kanji.mCharacters = stringArena->add(characters);
+                kanji.mMeaning = stringArena->add(meanings.join(", "));
+                kanji.mLevel = subjectDataMap["level"].toInt();
+
+                for (const auto &reading : subjectDataMap["readings"].toList()) {
+                    QVariantMap readingMap = reading.toMap();
+                    QString type = readingMap["type"].toString();
+
+                    if (!type.compare("onyomi")) {
+                        onyomi << readingMap["reading"].toString();
+                    } else if (!type.compare("kunyomi")) {
+                        kunyomi << readingMap["reading"].toString();
+                    } else if (!type.compare("nanori")) {
+                        nanori << readingMap["reading"].toString();
+                    }
+
+                    if (readingMap["primary"].toBool()) {
+                        kanji.mImportantReading = stringArena->add(type);
+                    }
+                }
+
+                kanji.mOnyomi = stringArena->add(onyomi.join(", "));
+                kanji.mKunyomi = stringArena->add(kunyomi.join(", "));
+                kanji.mNanori = stringArena->add(nanori.join(", "));
+
+                mKanjiSubjects.insert(id, kanji);
+            } else if (   !object.compare("vocabulary")
+                       || !object.compare("kana_vocabulary")) {
+                Vocabulary vocabulary;
+                QStringList kana = QStringList();
+
+                vocabulary.mCharacters = stringArena->add(characters);
+                vocabulary.mMeaning = stringArena->add(meanings.join(", "));
+                vocabulary.mLevel = subjectDataMap["level"].toInt();
+
+                for (const auto &reading : subjectDataMap["readings"].toList()) {
+                    QVariantMap readingMap = reading.toMap();
+
+                    if (readingMap["primary"].toBool()) {
+                        kana.prepend(readingMap["reading"].toString());
+                    } else {
+                        kana << readingMap["reading"].toString();
+                    }
+                }
+
+                vocabulary.mKana = stringArena->add(kana.isEmpty()?characters:kana.join(", "));
+
+                mVocabularySubjects.insert(id, vocabulary);
+            }
+        }
+
+        stringArena->squeeze();
+
+        Metrics::instance()->addParseTime(Metrics::SubjectsEndpoint, parseTimer.nsecsElapsed()/1000);
+        Metrics::instance()->setNbOfItems(Metrics::SubjectsEndpoint,
+                                          mRadicalSubjects.count()+mKanjiSubjects.count()+mVocabularySubjects.count());
+
+        if (!subjects.isEmpty()) {
+            mChanged = true;
+            mSubjectsOrAssignmentsChanged = true;
+        }
+
+        QString dataUpdatedAt = collectionMap["data_updated_at"].toString();
+
+        if (dataUpdatedAt > mNewSubjectsUpdatedAt) {
+            mNewSubjectsUpdatedAt = dataUpdatedAt;
+        }
+
+        QString nextRequest = nextPageRequest(collectionMap);
+
+        if (!nextRequest.isEmpty()) {
+            requestV2(nextRequest, LowPriority, &WaniKani::subjectsReply);
+        } else if (mNewSubjectsUpdatedAt != mSubjectsUpdatedAt) {
+            // Cache our subjects and reload them, so that their strings end up
+            // in one string arena rather than in one per page, some of which
+            // may now only hold strings of subjects that have since been
+            // updated
+
+            mSubjectsUpdatedAt = mNewSubjectsUpdatedAt;
+
+            if (saveSubjects()) {
+                loadSubjects();
+            }
+        }
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+void WaniKani::assignmentsReply()
+{
+    // Retrieve, if available, (a page of) the user's assignments that have been
+    // updated since we last retrieved them, and request the next page, if any
+    // Note: an assignment only holds the user's progress on a subject, so it is
+    //       much smaller than its v1 counterpart, which also holds the subject
+    //       itself...
+
+    // Note: SRS stage 0 is a lesson that hasn't been started yet, which the v1
+    //       API reports with an empty SRS name...
+
+    static const QStringList SrsNames = QStringList() << QString() << "apprentice" << "apprentice" << "apprentice" << "apprentice"
+                                                      << "guru" << "guru" << "master" << "enlighten" << "burned";
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    QJsonDocument jsonDocument;
+
+    if (waniKaniJsonResponse(networkReply, Metrics::AssignmentsEndpoint, jsonDocument)) {
+        QElapsedTimer parseTimer;
+
+        parseTimer.start();
+
+        QVariantMap collectionMap = jsonDocument.object().toVariantMap();
+        QVariantList assignments = collectionMap["data"].toList();
+
+        for (const auto &assignment : assignments) {
+            QVariantMap assignmentDataMap = assignment.toMap()["data"].toMap();
+            int subjectId = assignmentDataMap["subject_id"].toInt();
+
+            if (assignmentDataMap["hidden"].toBool()) {
+                mAssignments.remove(subjectId);
+
+                continue;
+            }
+
+            UserSpecific userSpecific;
+            int srsStage = qBound(0, assignmentDataMap["srs_stage"].toInt(), 9);
+
+            userSpecific.mSrs = SrsNames[srsStage];
+            userSpecific.mSrsNumeric = srsStage;
+            userSpecific.mUnlockedDate = epochTime(assignmentDataMap["unlocked_at"]);
+            userSpecific.mBurnedDate = epochTime(assignmentDataMap["burned_at"]);
+            userSpecific.mBurned = userSpecific.mBurnedDate != 0;
+            userSpecific.mAvailableDate = userSpecific.mBurned?0:epochTime(assignmentDataMap["available_at"]);
+
+            mAssignments.insert(subjectId, userSpecific);
+        }
+
+        Metrics::instance()->addParseTime(Metrics::AssignmentsEndpoint, parseTimer.nsecsElapsed()/1000);
+        Metrics::instance()->setNbOfItems(Metrics::AssignmentsEndpoint, mAssignments.count());
+
+        if (!assignments.isEmpty()) {
+            mChanged = true;
+            mSubjectsOrAssignmentsChanged = true;
+        }
+
+        QString dataUpdatedAt = collectionMap["data_updated_at"].toString();
+
+        if (dataUpdatedAt > mNewAssignmentsUpdatedAt) {
+            mNewAssignmentsUpdatedAt = dataUpdatedAt;
+        }
+
+        QString nextRequest = nextPageRequest(collectionMap);
+
+        if (!nextRequest.isEmpty()) {
+            requestV2(nextRequest, NormalPriority, &WaniKani::assignmentsReply);
+        } else {
+            mAssignmentsUpdatedAt = mNewAssignmentsUpdatedAt;
+        }
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+void WaniKani::reviewStatisticsReply()
+{
+    // Retrieve, if available, (a page of) the user's review statistics that
+    // have been updated since we last retrieved them, and request the next
+    // page, if any
+    // Note: v2 assignments don't include the user's answers, so this is where
+    //       our meaning/reading correct/incorrect counts and streaks come
+    //       from. We only keep those answer statistics, which get joined with
+    //       the user's assignments (see userSpecific())...
+
+    QNetworkReply *networkReply = qobject_cast<QNetworkReply *>(sender());
+
+    if (staleNetworkReply(networkReply)) {
+        return;
+    }
+
+    QJsonDocument jsonDocument;
+
+    if (waniKaniJsonResponse(networkReply, Metrics::ReviewStatisticsEndpoint, jsonDocument)) {
+        QElapsedTimer parseTimer;
+
+        parseTimer.start();
+
+        QVariantMap collectionMap = jsonDocument.object().toVariantMap();
+        QVariantList reviewStatistics = collectionMap["data"].toList();
+
+        for (const auto &reviewStatistic : reviewStatistics) {
+            QVariantMap reviewStatisticDataMap = reviewStatistic.toMap()["data"].toMap();
+            int subjectId = reviewStatisticDataMap["subject_id"].toInt();
+
+            if (reviewStatisticDataMap["hidden"].toBool()) {
+                mReviewStatistics.remove(subjectId);
+
+                continue;
+            }
+
+            UserSpecific userSpecific;
+
+            userSpecific.mMeaningCorrect = reviewStatisticDataMap["meaning_correct"].toInt();
+            userSpecific.mMeaningIncorrect = reviewStatisticDataMap["meaning_incorrect"].toInt();
+            userSpecific.mMeaningMaxStreak = reviewStatisticDataMap["meaning_max_streak"].toInt();
+            userSpecific.mMeaningCurrentStreak = reviewStatisticDataMap["meaning_current_streak"].toInt();
+            userSpecific.mReadingCorrect = reviewStatisticDataMap["reading_correct"].toInt();
+            userSpecific.mReadingIncorrect = reviewStatisticDataMap["reading_incorrect"].toInt();
+            userSpecific.mReadingMaxStreak = reviewStatisticDataMap["reading_max_streak"].toInt();
+            userSpecific.mReadingCurrentStreak = reviewStatisticDataMap["reading_current_streak"].toInt();
+
+            mReviewStatistics.insert(subjectId, userSpecific);
+        }
+
+        Metrics::instance()->addParseTime(Metrics::ReviewStatisticsEndpoint, parseTimer.nsecsElapsed()/1000);
+        Metrics::instance()->setNbOfItems(Metrics::ReviewStatisticsEndpoint, mReviewStatistics.count());
+
+        if (!reviewStatistics.isEmpty()) {
+            mChanged = true;
+            mSubjectsOrAssignmentsChanged = true;
+        }
+
+        QString dataUpdatedAt = collectionMap["data_updated_at"].toString();
+
+        if (dataUpdatedAt > mNewReviewStatisticsUpdatedAt) {
+            mNewReviewStatisticsUpdatedAt = dataUpdatedAt;
+        }
+
+        QString nextRequest = nextPageRequest(collectionMap);
+
+        if (!nextRequest.isEmpty()) {
+            requestV2(nextRequest, NormalPriority, &WaniKani::reviewStatisticsReply);
+        } else {
+            mReviewStatisticsUpdatedAt = mNewReviewStatisticsUpdatedAt;
+        }
+    }
+
+    checkNbOfReplies();
+}
+
+//==============================================================================
+
+template<typename T>
+void WaniKani::joinItems(QFuture<ItemsResponse<T>> &pFuture,
+                         Metrics::Endpoint pEndpoint, T &pItems)
+{
+    // Wait for the given items to have been decoded, if they are being
+    // decoded, and keep track of them, if they are valid
+    // Note: an empty future is a cancelled one...
+
+    if (pFuture.isCanceled()) {
+        return;
+    }
+
+    ItemsResponse<T> itemsResponse = pFuture.result();
+
+    pFuture = QFuture<ItemsResponse<T>>();
+
+    if (validResponse(pEndpoint, itemsResponse.valid)) {
+        pItems = itemsResponse.items;
+
+        mChanged = true;
+    }
+}
+
+//==============================================================================
+
+UserSpecific WaniKani::userSpecific(int pSubjectId) const
+{
+    // Return the user's assignment for the given subject, completed with the
+    // user's review statistics for it, if any
+
+    UserSpecific res = mAssignments.value(pSubjectId);
+    auto reviewStatistic = mReviewStatistics.constFind(pSubjectId);
+
+    if (reviewStatistic != mReviewStatistics.constEnd()) {
+        res.mMeaningCorrect = reviewStatistic->mMeaningCorrect;
+        res.mMeaningIncorrect = reviewStatistic->mMeaningIncorrect;
+        res.mMeaningMaxStreak = reviewStatistic->mMeaningMaxStreak;
+        res.mMeaningCurrentStreak = reviewStatistic->mMeaningCurrentStreak;
+        res.mReadingCorrect = reviewStatistic->mReadingCorrect;
+        res.mReadingIncorrect = reviewStatistic->mReadingIncorrect;
+        res.mReadingMaxStreak = reviewStatistic->mReadingMaxStreak;
+        res.mReadingCurrentStreak = reviewStatistic->mReadingCurrentStreak;
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+void WaniKani::joinSubjectsAndAssignments()
+{
+    // Join our subjects and the user's assignments (and review statistics) into
+    // our radicals, Kanji and vocabulary
+    // Note: a subject without an assignment is one that the user hasn't
+    //       unlocked yet...
+
+    Radicals radicals = Radicals();
+    Kanjis kanjis = Kanjis();
+    Vocabularies vocabularies = Vocabularies();
+
+    radicals.reserve(mRadicalSubjects.count());
+    kanjis.reserve(mKanjiSubjects.count());
+    vocabularies.reserve(mVocabularySubjects.count());
+
+    for (auto subject = mRadicalSubjects.constBegin(), endSubject = mRadicalSubjects.constEnd();
+         subject != endSubject; ++subject) {
+        Radical radical = subject.value();
+
+        radical.mId = subject.key();
+
+        radical.mUserSpecific = userSpecific(subject.key());
+
+        radicals << radical;
+    }
+
+    for (auto subject = mKanjiSubjects.constBegin(), endSubject = mKanjiSubjects.constEnd();
+         subject != endSubject; ++subject) {
+        Kanji kanji = subject.value();
+
+        kanji.mId = subject.key();
+
+        static_cast<UserSpecific &>(kanji.mUserSpecific) = userSpecific(subject.key());
+
+        kanjis << kanji;
+    }
+
+    for (auto subject = mVocabularySubjects.constBegin(), endSubject = mVocabularySubjects.constEnd();
+         subject != endSubject; ++subject) {
+        Vocabulary vocabulary = subject.value();
+
+        vocabulary.mId = subject.key();
+
+        static_cast<UserSpecific &>(vocabulary.mUserSpecific) = userSpecific(subject.key());
+
+        vocabularies << vocabulary;
+    }
+
+    mRadicals = radicals;
+    mKanjis = kanjis;
+    mVocabularies = vocabularies;
+
+    Metrics::instance()->setNbOfItems(Metrics::RadicalsEndpoint, mRadicals.count());
+    Metrics::instance()->setNbOfItems(Metrics::KanjiEndpoint, mKanjis.count());
+    Metrics::instance()->setNbOfItems(Metrics::VocabularyEndpoint, mVocabularies.count());
+}
+
+//==============================================================================
+
+void WaniKani::checkNbOfReplies()
+{
+    // Check whether we have got all of our replies and, if so, let people know
+    // whether things are valid or not
+    // Note: we only keep track of the endpoints we have actually requested, so
+    //       an endpoint that is still fresh doesn't hold us back...
+
+    // Note: if none of our responses has changed, then there is nothing for us
+    //       (or people) to update...
+
+    if (!updating()) {
+        // Join our thread pool, if needed
+
+        joinItems(mRadicalsFuture, Metrics::RadicalsEndpoint, mRadicals);
+        joinItems(mKanjisFuture, Metrics::KanjiEndpoint, mKanjis);
+        joinItems(mVocabulariesFuture, Metrics::VocabularyEndpoint, mVocabularies);
+
+        // Publish the parse time of the endpoints that we have requested
+
+        Metrics::instance()->publishParseTimes();
+
+        // Join our subjects and the user's assignments, if needed
+
+        if (mSubjectsOrAssignmentsChanged) {
+            joinSubjectsAndAssignments();
+        }
+
+        // Release the memory that was used to process our responses, once we
+        // (and people) are done with them
+
+        QTimer::singleShot(0, this, &WaniKani::releaseMemory);
+
+        // Check whether we got at least one valid response during our update
+        // Note: we only consider the endpoints that we requested during our
+        //       update, so that a (still) valid response from a previous update
+        //       doesn't hide the fact that all our requests failed...
+
+        bool validResponses = false;
+
+        for (int endpoint = 0; endpoint < Metrics::NbOfEndpoints; ++endpoint) {
+            validResponses = validResponses || (mRequestedEndpoints[endpoint] && mValidResponses[endpoint]);
+        }
+
+        if (validResponses) {
+            if (mChanged) {
+                // Derive some information from our items, if we have some
+
+                if (   mFetchTimes[Metrics::RadicalsEndpoint]
+                    || mFetchTimes[Metrics::KanjiEndpoint]
+                    || mFetchTimes[Metrics::VocabularyEndpoint]
+                    || mFetchTimes[Metrics::AssignmentsEndpoint]
+                    || mFetchTimes[Metrics::ReviewStatisticsEndpoint]) {
+                    deriveInformation();
+                }
+
+                // Publish our new snapshot and let people know what has changed
+                // since our previous one and that we have been updated
+
+                std::shared_ptr<const Snapshot> oldSnapshot = snapshot();
+
+                publishSnapshot();
+
+                emitChanges(*oldSnapshot, *snapshot());
+
+                emit updated();
+            } else {
+                // Let people know that nothing has changed
+
+                emit unchanged();
+            }
+        } else {
+            // Let people know that something went wrong
+
+            emit error();
+        }
+
+        // Do the forced update that joined our update, if any
+
+        if (mForcedUpdatePending) {
+            mForcedUpdatePending = false;
+
+            QMetaObject::invokeMethod(this, "doUpdate", Qt::QueuedConnection,
+                                      Q_ARG(bool, true));
+        }
+    }
+}
+
+//==============================================================================
+
+ItemColumns WaniKani::itemColumns(const Radicals &pRadicals,
+                                  const Kanjis &pKanjis,
+                                  const Vocabularies &pVocabularies)
+{
+    // Return the given radicals, Kanji and vocabulary, column by column and in
+    // that order
+    // Note: only the meaning of a radical gets reviewed, so we only account for
+    //       its meaning answers...
+
+    ItemColumns res;
+
+    res.reserve(pRadicals.count()+pKanjis.count()+pVocabularies.count());
+
+    for (const auto &radical : pRadicals) {
+        const UserSpecific &userSpecific = radical.userSpecific();
+
+        res.add(ItemColumns::RadicalType, radical, userSpecific,
+                userSpecific.meaningCorrect(), userSpecific.meaningIncorrect(),
+                QChar());
+    }
+
+    for (const auto &kanji : pKanjis) {
+        const ExtraUserSpecific &userSpecific = kanji.userSpecific();
+
+        res.add(ItemColumns::KanjiType, kanji, userSpecific,
+                userSpecific.meaningCorrect()+userSpecific.readingCorrect(),
+                userSpecific.meaningIncorrect()+userSpecific.readingIncorrect(),
+                kanji.character());
+    }
+
+    for (const auto &vocabulary : pVocabularies) {
+        const ExtraUserSpecific &userSpecific = vocabulary.userSpecific();
+
+        res.add(ItemColumns::VocabularyType, vocabulary, userSpecific,
+                userSpecific.meaningCorrect()+userSpecific.readingCorrect(),
+                userSpecific.meaningIncorrect()+userSpecific.readingIncorrect(),
+                QChar());
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+void WaniKani::publishSnapshot()
+{
+    // Publish an immutable snapshot of our information
+    // Note: our lists are implicitly shared, so they don't get copied here, and
+    //       they get detached from our snapshot as soon as we update them...
+
+    Snapshot *snapshot = new Snapshot();
+
+    snapshot->mUser = mUser;
+    snapshot->mStudyQueue = mStudyQueue;
+    snapshot->mLevelProgression = mLevelProgression;
+    snapshot->mSrsDistribution = mSrsDistribution;
+    snapshot->mRadicals = mRadicals;
+    snapshot->mKanjis = mKanjis;
+    snapshot->mVocabularies = mVocabularies;
+
+    // Lay out our items column by column, so that people can go through all of
+    // them in one pass, reading only the columns they need, unless our items
+    // haven't changed, in which case our columns (which are implicitly shared)
+    // haven't either
+
+    std::shared_ptr<const Snapshot> oldSnapshot = std::atomic_load(&mSnapshot);
+
+    if (   oldSnapshot->mRadicals.isSharedWith(mRadicals)
+        && oldSnapshot->mKanjis.isSharedWith(mKanjis)
+        && oldSnapshot->mVocabularies.isSharedWith(mVocabularies)) {
+        snapshot->mItemColumns = oldSnapshot->mItemColumns;
+    } else {
+        snapshot->mItemColumns = itemColumns(mRadicals, mKanjis, mVocabularies);
+    }
+
+    std::atomic_store(&mSnapshot, std::shared_ptr<const Snapshot>(snapshot));
+}
+
+//==============================================================================
+
+static bool sameUser(const User &pUser1, const User &pUser2)
+{
+    // Return whether the two users are the same
+
+    return    (pUser1.level() == pUser2.level())
+           && (pUser1.userName() == pUser2.userName())
+           && (pUser1.profileUrl() == pUser2.profileUrl())
+           && (pUser1.currentVacationStartedAt() == pUser2.currentVacationStartedAt());
+}
+
+//==============================================================================
+
+static bool sameStudyQueue(const StudyQueue &pStudyQueue1,
+                           const StudyQueue &pStudyQueue2)
+{
+    // Return whether the two study queues are the same
+
+    return    (pStudyQueue1.lessonsAvailable() == pStudyQueue2.lessonsAvailable())
+           && (pStudyQueue1.reviewsAvailable() == pStudyQueue2.reviewsAvailable())
+           && (pStudyQueue1.nextReviewDate() == pStudyQueue2.nextReviewDate())
+           && (pStudyQueue1.reviewsAvailableNextHour() == pStudyQueue2.reviewsAvailableNextHour())
+           && (pStudyQueue1.reviewsAvailableNextDay() == pStudyQueue2.reviewsAvailableNextDay());
+}
+
+//==============================================================================
+
+static bool sameLevelProgression(const LevelProgression &pLevelProgression1,
+                                 const LevelProgression &pLevelProgression2)
+{
+    // Return whether the two level progressions are the same
+
+    return    (pLevelProgression1.radicalsProgress() == pLevelProgression2.radicalsProgress())
+           && (pLevelProgression1.radicalsTotal() == pLevelProgression2.radicalsTotal())
+           && (pLevelProgression1.kanjiProgress() == pLevelProgression2.kanjiProgress())
+           && (pLevelProgression1.kanjiTotal() == pLevelProgression2.kanjiTotal());
+}
+
+//==============================================================================
+
+static bool sameSrsDistributionInformation(const SrsDistributionInformation &pInformation1,
+                                           const SrsDistributionInformation &pInformation2)
+{
+    // Return whether the two SRS distribution information are the same
+
+    return    (pInformation1.radicals() == pInformation2.radicals())
+           && (pInformation1.kanji() == pInformation2.kanji())
+           && (pInformation1.vocabulary() == pInformation2.vocabulary())
+           && (pInformation1.total() == pInformation2.total());
+}
+
+//==============================================================================
+
+static bool sameSrsDistribution(const SrsDistribution &pSrsDistribution1,
+                                const SrsDistribution &pSrsDistribution2)
+{
+    // Return whether the two SRS distributions are the same
+
+    return    sameSrsDistributionInformation(pSrsDistribution1.apprentice(), pSrsDistribution2.apprentice())
+           && sameSrsDistributionInformation(pSrsDistribution1.guru(), pSrsDistribution2.guru())
+           && sameSrsDistributionInformation(pSrsDistribution1.master(), pSrsDistribution2.master())
+           && sameSrsDistributionInformation(pSrsDistribution1.enlightened(), pSrsDistribution2.enlightened())
+           && sameSrsDistributionInformation(pSrsDistribution1.burned(), pSrsDistribution2.burned());
+}
+
+//==============================================================================
+
+template<typename T>
+static bool sameItem(const T &pItem1, const T &pItem2)
+{
+    // Return whether the two items are the same, as far as what we derive from
+    // them is concerned
+
+    const UserSpecific &userSpecific1 = pItem1.userSpecific();
+    const UserSpecific &userSpecific2 = pItem2.userSpecific();
+
+    return    (pItem1.level() == pItem2.level())
+           && (userSpecific1.srsNumeric() == userSpecific2.srsNumeric())
+           && (userSpecific1.unlockedDate() == userSpecific2.unlockedDate())
+           && (userSpecific1.availableDate() == userSpecific2.availableDate())
+           && (userSpecific1.burnedDate() == userSpecific2.burnedDate())
+           && (userSpecific1.meaningCorrect() == userSpecific2.meaningCorrect())
+           && (userSpecific1.meaningIncorrect() == userSpecific2.meaningIncorrect())
+           && (userSpecific1.readingCorrect() == userSpecific2.readingCorrect())
+           && (userSpecific1.readingIncorrect() == userSpecific2.readingIncorrect())
+           && (pItem1.characters() == pItem2.characters())
+           && (pItem1.meaning() == pItem2.meaning());
+}
+
+//==============================================================================
+
+template<typename T>
+static bool sameViewedItem(const T &pItem1, const T &pItem2)
+{
+    // Return whether the two items are the same, as far as what people can see
+    // of them through our item columns is concerned (see itemColumns())
+
+    const UserSpecific &userSpecific1 = pItem1.userSpecific();
+    const UserSpecific &userSpecific2 = pItem2.userSpecific();
+
+    return    (pItem1.level() == pItem2.level())
+           && (userSpecific1.srsNumeric() == userSpecific2.srsNumeric())
+           && (userSpecific1.srs() == userSpecific2.srs())
+           && (userSpecific1.unlockedDate() == userSpecific2.unlockedDate())
+           && (userSpecific1.availableDate() == userSpecific2.availableDate())
+           && (userSpecific1.meaningCorrect() == userSpecific2.meaningCorrect())
+           && (userSpecific1.meaningIncorrect() == userSpecific2.meaningIncorrect())
+           && (userSpecific1.readingCorrect() == userSpecific2.readingCorrect())
+           && (userSpecific1.readingIncorrect() == userSpecific2.readingIncorrect())
+           && (pItem1.characters() == pItem2.characters());
+}
+
+//==============================================================================
+
+static quint64 itemKey(const Item &pItem, quint64 pItemType)
+{
+    // Return the key of the given item, i.e. its type and id or, if it doesn't
+    // have an id (i.e. it doesn't come from a subject), its type, level,
+    // characters and meaning
+
+    quint64 res = pItemType << 62;
+
+    if (pItem.id()) {
+        return res|quint64(pItem.id());
+    }
+
+    return res|(quint64(1) << 61)|(quint64(pItem.level()) << 32)|qHash(pItem.characters(), qHash(pItem.meaning()));
+}
+
+//==============================================================================
+
+template<typename T>
+static QVector<QPair<quint64, int>> itemKeys(const T &pItems, quint64 pItemType)
+{
+    // Return the (sorted) keys of the given items, together with their index
+    // Note: items that come from our subjects are already sorted by id, so we
+    //       only need to sort our keys for the other ones...
+
+    QVector<QPair<quint64, int>> res;
+
+    res.reserve(pItems.count());
+
+    for (int i = 0, iMax = pItems.count(); i < iMax; ++i) {
+        res << qMakePair(itemKey(pItems[i], pItemType), i);
+    }
+
+    if (!std::is_sorted(res.constBegin(), res.constEnd())) {
+        std::sort(res.begin(), res.end());
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+template<typename T>
+static void diffItems(const T &pOldItems, const T &pNewItems,
+                      quint64 pItemType, QVector<quint64> &pChangedItems,
+                      int &pNbOfChangedItems)
+{
+    // Determine which items have been added, removed or modified, unless our
+    // old and new items are shared, in which case nothing has changed
+    // Note: we count all the items that have changed, but only keep track of
+    //       the ones that people can tell have changed, so that they don't
+    //       redo anything when only, say, the burned date or meaning of an
+    //       item has changed...
+
+    if (pOldItems.isSharedWith(pNewItems)) {
+        return;
+    }
+
+    QVector<QPair<quint64, int>> oldKeys = itemKeys(pOldItems, pItemType);
+    QVector<QPair<quint64, int>> newKeys = itemKeys(pNewItems, pItemType);
+    int i = 0;
+    int j = 0;
+    int iMax = oldKeys.count();
+    int jMax = newKeys.count();
+
+    while ((i < iMax) || (j < jMax)) {
+        if ((j == jMax) || ((i < iMax) && (oldKeys[i].first < newKeys[j].first))) {
+            pChangedItems << oldKeys[i++].first;
+
+            ++pNbOfChangedItems;
+        } else if ((i == iMax) || (newKeys[j].first < oldKeys[i].first)) {
+            pChangedItems << newKeys[j++].first;
+
+            ++pNbOfChangedItems;
+        } else {
+            const auto &oldItem = pOldItems[oldKeys[i].second];
+            const auto &newItem = pNewItems[newKeys[j].second];
+
+            if (!sameViewedItem(oldItem, newItem)) {
+                pChangedItems << newKeys[j].first;
+
+                ++pNbOfChangedItems;
+            } else if (!sameItem(oldItem, newItem)) {
+                ++pNbOfChangedItems;
+            }
+
+            ++i;
+            ++j;
+        }
+    }
+}
+
+//==============================================================================
+
+void WaniKani::emitChanges(const Snapshot &pOldSnapshot,
+                           const Snapshot &pNewSnapshot)
+{
+    // Compare our old and new snapshots and let people know about what has
+    // changed, so that they only need to update what depends on it
+    // Note: our items are compared by merging their sorted keys...
+
+    QElapsedTimer diffTimer;
+
+    diffTimer.start();
+
+    QVector<quint64> changedItems = QVector<quint64>();
+    int nbOfChangedItems = 0;
+
+    diffItems(pOldSnapshot.radicals(), pNewSnapshot.radicals(),
+              ItemColumns::RadicalType, changedItems, nbOfChangedItems);
+    diffItems(pOldSnapshot.kanjis(), pNewSnapshot.kanjis(),
+              ItemColumns::KanjiType, changedItems, nbOfChangedItems);
+    diffItems(pOldSnapshot.vocabularies(), pNewSnapshot.vocabularies(),
+              ItemColumns::VocabularyType, changedItems, nbOfChangedItems);
+
+    Metrics::instance()->set(Metrics::SnapshotDiffTime, diffTimer.nsecsElapsed()/1000);
+    Metrics::instance()->set(Metrics::ChangedItems, nbOfChangedItems);
+
+    if (!sameUser(pOldSnapshot.user(), pNewSnapshot.user())) {
+        emit userChanged();
+    }
+
+    if (!sameStudyQueue(pOldSnapshot.studyQueue(), pNewSnapshot.studyQueue())) {
+        emit studyQueueChanged();
+    }
+
+    if (!sameLevelProgression(pOldSnapshot.levelProgression(), pNewSnapshot.levelProgression())) {
+        emit levelProgressionChanged();
+    }
+
+    if (!sameSrsDistribution(pOldSnapshot.srsDistribution(), pNewSnapshot.srsDistribution())) {
+        emit srsDistributionChanged();
+    }
+
+    if (!changedItems.isEmpty()) {
+        emit itemsChanged(changedItems);
+    }
+}
+
+//==============================================================================
+
+void WaniKani::releaseMemory()
+{
+    // Release the free memory on our heap and keep track of how much memory we
+    // are using now that we are done with our update
+
+    Metrics::trimHeap();
+
+    Metrics::instance()->set(Metrics::HeapSizeAfterUpdate, Metrics::heapSize());
+    Metrics::instance()->set(Metrics::ResidentSetSizeAfterUpdate, Metrics::residentSetSize());
+}
+
+//==============================================================================
+
+void WaniKani::doUpdate(bool pForce)
+{
+    // Join our in-flight update, if any, since it will let people know about
+    // the outcome of that update
+    // Note: if we are forced to update, then we need to remember it, so that
+    //       we can do a forced update once our in-flight update is done (see
+    //       checkNbOfReplies())...
+
+    if (updating()) {
+        Metrics::instance()->add(Metrics::UpdatesJoined);
+
+        mForcedUpdatePending = mForcedUpdatePending || pForce;
+
+        return;
+    }
+
+    // Make sure that we have an API key
+
+    bool hasApiKey = !mApiKey.isEmpty();
+    bool hasApiToken = !mApiToken.isEmpty();
+
+    if (!hasApiKey && !hasApiToken) {
+        emit error();
+
+        return;
+    }
+
+    // Retrieve
+    //  - the user's information and study queue
+    //  - the user's SRS distribution
+    //  - the user's list of radicals (and their information)
+    //  - the user's list of Kanji (and their information)
+    //  - the user's list of vocabulary (and their information)
+
+    bool retrieveV2Data = hasApiToken && (pForce || !mUser.mHasData);
+
+    for (auto &requestedEndpoint : mRequestedEndpoints) {
+        requestedEndpoint = false;
+    }
+
+    if (retrieveV2Data) {
+        requestEndpoint(Metrics::UserEndpoint);
+    }
+
+    mUpdateTime = QDateTime::currentSecsSinceEpoch();
+    mChanged = pForce;
+
+    mNewSubjectsUpdatedAt = mSubjectsUpdatedAt;
+    mNewAssignmentsUpdatedAt = mAssignmentsUpdatedAt;
+    mNewReviewStatisticsUpdatedAt = mReviewStatisticsUpdatedAt;
+    mSubjectsOrAssignmentsChanged = false;
+
+    // Note: if we are forced to or if we have never retrieved the user's study
+    //       queue, then we retrieve everything at once, otherwise we first
+    //       retrieve the user's study queue and then only the endpoints that
+    //       are stale (see studyQueueReply()). Without an API key, there is no
+    //       study queue to tell us whether the user's progress has changed, so
+    //       we always request the user's assignments and review statistics
+    //       (which is cheap since we only ask for those that have been updated
+    //       since we last retrieved them) and derive the study queue from them
+    //       (see deriveInformation())...
+
+    if (pForce || (hasApiKey && !mFetchTimes[Metrics::StudyQueueEndpoint])) {
+        for (int endpoint = Metrics::StudyQueueEndpoint; endpoint < Metrics::NbOfEndpoints; ++endpoint) {
+            if (usedEndpoint(Metrics::Endpoint(endpoint))) {
+                requestEndpoint(Metrics::Endpoint(endpoint));
+            }
+        }
+    } else if (hasApiKey) {
+        requestEndpoint(Metrics::StudyQueueEndpoint)->setProperty(StaleEndpointsProperty, true);
+    } else {
+        requestStaleEndpoints(true);
+    }
+}
+
+//==============================================================================
+
+bool WaniKani::usedEndpoint(Metrics::Endpoint pEndpoint) const
+{
+    // Return whether the given endpoint is used, i.e. our v1 endpoints if we
+    // have an API key, except for our v1 radicals, Kanji and vocabulary
+    // endpoints if we have an API token, in which case our items come from our
+    // v2 subjects and the user's v2 assignments and review statistics
+
+    switch (pEndpoint) {
+    case Metrics::UserEndpoint:
+        return !mApiToken.isEmpty();
+    case Metrics::StudyQueueEndpoint:
+    case Metrics::LevelProgressionEndpoint:
+    case Metrics::SrsDistributionEndpoint:
+        return !mApiKey.isEmpty();
+    case Metrics::RadicalsEndpoint:
+    case Metrics::KanjiEndpoint:
+    case Metrics::VocabularyEndpoint:
+        return mApiToken.isEmpty();
+    case Metrics::SubjectsEndpoint:
+    case Metrics::AssignmentsEndpoint:
+    case Metrics::ReviewStatisticsEndpoint:
+        return !mApiToken.isEmpty();
+    default:
+        return false;
+    }
+}
+
+//==============================================================================
+
+bool WaniKani::freshEndpoint(Metrics::Endpoint pEndpoint) const
+{
+    // Return whether the given endpoint has been retrieved and is still within
+    // its time to live
+
+    return    mFetchTimes[pEndpoint]
+           && (QDateTime::currentSecsSinceEpoch()-mFetchTimes[pEndpoint] < EndpointTimesToLive[pEndpoint]);
+}
+
+//==============================================================================
+
+QNetworkReply * WaniKani::requestEndpoint(Metrics::Endpoint pEndpoint)
+{
+    // Request the given endpoint, keeping track of the fact that we have
+    // requested it during our update and that we don't have a valid response
+    // for it yet
+
+    QNetworkReply *res = nullptr;
+
+    mRequestedEndpoints[pEndpoint] = true;
+    mValidResponses[pEndpoint] = false;
+
+    Metrics::instance()->resetParseTime(pEndpoint);
+
+    switch (pEndpoint) {
+    case Metrics::UserEndpoint:
+        requestV2("user", HighPriority, &WaniKani::userReply);
+
+        break;
+    case Metrics::StudyQueueEndpoint:
+        res = waniKaniNetworkReply("study-queue");
+
+        QObject::connect(res, &QNetworkReply::finished,
+                         this, &WaniKani::studyQueueReply);
+
+        break;
+    case Metrics::LevelProgressionEndpoint:
+        res = waniKaniNetworkReply("level-progression");
+
+        QObject::connect(res, &QNetworkReply::finished,
+                         this, &WaniKani::levelProgressionReply);
+
+        break;
+    case Metrics::SrsDistributionEndpoint:
+        res = waniKaniNetworkReply("srs-distribution");
+
+        QObject::connect(res, &QNetworkReply::finished,
+                         this, &WaniKani::srsDistributionReply);
+
+        break;
+    case Metrics::RadicalsEndpoint:
+        res = waniKaniNetworkReply("radicals/1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60");
+
+        QObject::connect(res, &QNetworkReply::finished,
+                         this, &WaniKani::radicalsReply);
+
+        break;
+    case Metrics::KanjiEndpoint:
+        res = waniKaniNetworkReply("kanji/1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60");
+
+        QObject::connect(res, &QNetworkReply::finished,
+                         this, &WaniKani::kanjiReply);
+
+        break;
+    case Metrics::VocabularyEndpoint:
+        res = waniKaniNetworkReply("vocabulary/1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60");
+
+        QObject::connect(res, &QNetworkReply::finished,
+                         this, &WaniKani::vocabularyReply);
+
+        break;
+    case Metrics::SubjectsEndpoint:
+        requestV2(updatedAfterRequest("subjects", mSubjectsUpdatedAt),
+                  LowPriority, &WaniKani::subjectsReply);
+
+        break;
+    case Metrics::AssignmentsEndpoint:
+        requestV2(updatedAfterRequest("assignments", mAssignmentsUpdatedAt),
+                  NormalPriority, &WaniKani::assignmentsReply);
+
+        break;
+    case Metrics::ReviewStatisticsEndpoint:
+        requestV2(updatedAfterRequest("review_statistics", mReviewStatisticsUpdatedAt),
+                  NormalPriority, &WaniKani::reviewStatisticsReply);
+
+        break;
+    default:
+        break;
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+void WaniKani::requestStaleEndpoints(bool pStudyQueueChanged)
+{
+    // Request the endpoints that depend on the user's study queue, but only if
+    // the user's study queue has changed (i.e. the user has done some lessons
+    // and/or reviews, or some reviews have become available) or if they are
+    // past their time to live
+    // Note: our level progression and SRS distribution are derived from our
+    //       items, so their endpoints are only retrieved as a cross-check, i.e.
+    //       when they are past their time to live. Our subjects don't depend
+    //       on the user's progress, so they too are only retrieved when they
+    //       are past their time to live...
+
+    for (int endpoint = Metrics::LevelProgressionEndpoint; endpoint < Metrics::NbOfEndpoints; ++endpoint) {
+        if (!usedEndpoint(Metrics::Endpoint(endpoint))) {
+            continue;
+        }
+
+        bool ttlOnlyEndpoint =    (endpoint == Metrics::LevelProgressionEndpoint)
+                               || (endpoint == Metrics::SrsDistributionEndpoint)
+                               || (endpoint == Metrics::SubjectsEndpoint);
+
+        if (   (pStudyQueueChanged && !ttlOnlyEndpoint)
+            || !freshEndpoint(Metrics::Endpoint(endpoint))) {
+            requestEndpoint(Metrics::Endpoint(endpoint));
+        } else {
+            Metrics::instance()->add(Metrics::EndpointsSkipped);
+        }
+    }
+}
+
+//==============================================================================
+
+void WaniKani::update()
+{
+    // Update ourselves, in our own thread
+
+    QMetaObject::invokeMethod(this, "doUpdate",
+                              Q_ARG(bool, false));
+}
+
+//==============================================================================
+
+void WaniKani::forceUpdate()
+{
+    // Forcely update ourselves, in our own thread
+
+    QMetaObject::invokeMethod(this, "doUpdate",
+                              Q_ARG(bool, true));
+}
+
+//==============================================================================
+
+bool WaniKani::fetchedEndpoint(Metrics::Endpoint pEndpoint) const
+{
+    // Return whether the given endpoint has been retrieved as part of our
+    // current update
+
+    return mFetchTimes[pEndpoint] && (mFetchTimes[pEndpoint] >= mUpdateTime);
+}
+
+//==============================================================================
+
+void WaniKani::deriveInformation()
+{
+    // Derive the user's SRS distribution, level progression and (reviews part
+    // of the) study queue from our radicals, Kanji and vocabulary, all in one
+    // pass
+    // Note: if the corresponding endpoints have been retrieved as part of our
+    //       current update, then we use them to cross-check what we derive.
+    //       Also, without an API key, we don't have a study queue, so we also
+    //       derive the lessons part of it, i.e. the items that have been
+    //       unlocked but not yet started...
+
+    enum {
+        MaximumLevel = 60,
+        NbOfItemTypes = 3,
+        NbOfSrsStages = 5
+    };
+
+    static const int SrsStages[] = { -1, 0, 0, 0, 0, 1, 1, 2, 3, 4 };
+
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    int srsDistribution[NbOfSrsStages][NbOfItemTypes] = {};
+    int progress[NbOfItemTypes][MaximumLevel+1] = {};
+    int total[NbOfItemTypes][MaximumLevel+1] = {};
+    int highestLevel = 0;
+    int lessonsAvailable = 0;
+    StudyQueue studyQueue = mReportedStudyQueue;
+
+    studyQueue.mReviewsAvailable = 0;
+    studyQueue.mNextReviewDate = 0;
+    studyQueue.mReviewsAvailableNextHour = 0;
+    studyQueue.mReviewsAvailableNextDay = 0;
+
+    auto deriveItem = [&](int pItemType, const Item &pItem,
+                          const UserSpecific &pUserSpecific) {
+        int level = qBound(0, pItem.mLevel, int(MaximumLevel));
+        int srsStage = SrsStages[qBound(0, pUserSpecific.mSrsNumeric, 9)];
+
+        ++total[pItemType][level];
+
+        if (srsStage < 0) {
+            if (pUserSpecific.mUnlockedDate) {
+                ++lessonsAvailable;
+            }
+
+            return;
+        }
+
+        // The item has been unlocked, so account for it in our SRS
+        // distribution and level progression
+
+        ++srsDistribution[srsStage][pItemType];
+
+        if (pUserSpecific.mSrsNumeric >= 5) {
+            ++progress[pItemType][level];
+        }
+
+        highestLevel = qMax(highestLevel, level);
+
+        // Account for the item's next review, if any
+
+        uint availableDate = pUserSpecific.mAvailableDate;
+
+        if (availableDate) {
+            if (!studyQueue.mNextReviewDate || (availableDate < studyQueue.mNextReviewDate)) {
+                studyQueue.mNextReviewDate = availableDate;
+            }
+
+            if (availableDate <= now) {
+                ++studyQueue.mReviewsAvailable;
+            }
+
+            if (availableDate <= now+3600) {
+                ++studyQueue.mReviewsAvailableNextHour;
+            }
+
+            if (availableDate <= now+86400) {
+                ++studyQueue.mReviewsAvailableNextDay;
+            }
+        }
+    };
+
+    for (const auto &radical : mRadicals) {
+        deriveItem(0, radical, radical.mUserSpecific);
+    }
+
+    for (const auto &kanji : mKanjis) {
+        deriveItem(1, kanji, kanji.mUserSpecific);
+    }
+
+    for (const auto &vocabulary : mVocabularies) {
+        deriveItem(2, vocabulary, vocabulary.mUserSpecific);
+    }
+
+    if (mApiKey.isEmpty()) {
+        studyQueue.mLessonsAvailable = lessonsAvailable;
+    }
+
+    // Finalise our SRS distribution
+
+    static const QStringList SrsStageNames = QStringList() << "Apprentice" << "Guru" << "Master" << "Enlightened" << "Burned";
+
+    SrsDistribution derivedSrsDistribution;
+    SrsDistributionInformation *srsDistributionInformations[NbOfSrsStages] = {
+        &derivedSrsDistribution.mApprentice,
+        &derivedSrsDistribution.mGuru,
+        &derivedSrsDistribution.mMaster,
+        &derivedSrsDistribution.mEnlightened,
+        &derivedSrsDistribution.mBurned
+    };
+    bool srsDistributionMismatch = false;
+    SrsDistributionInformation reportedSrsDistributionInformations[NbOfSrsStages] = {
+        mReportedSrsDistribution.mApprentice,
+        mReportedSrsDistribution.mGuru,
+        mReportedSrsDistribution.mMaster,
+        mReportedSrsDistribution.mEnlightened,
+        mReportedSrsDistribution.mBurned
+    };
+
+    for (int i = 0; i < NbOfSrsStages; ++i) {
+        SrsDistributionInformation *information = srsDistributionInformations[i];
+
+        information->mName = SrsStageNames[i];
+        information->mRadicals = QString::number(srsDistribution[i][0]);
+        information->mKanji = QString::number(srsDistribution[i][1]);
+        information->mVocabulary = QString::number(srsDistribution[i][2]);
+        information->mTotal = QString::number(srsDistribution[i][0]+srsDistribution[i][1]+srsDistribution[i][2]);
+
+        srsDistributionMismatch =    srsDistributionMismatch
+                                  || (information->mRadicals != reportedSrsDistributionInformations[i].mRadicals)
+                                  || (information->mKanji != reportedSrsDistributionInformations[i].mKanji)
+                                  || (information->mVocabulary != reportedSrsDistributionInformations[i].mVocabulary);
+    }
+
+    // Finalise our level progression, using the user's level or, if we don't
+    // know it, the highest level at which the user has unlocked some items
+
+    int level = mUser.mHasData?qBound(0, mUser.mLevel, int(MaximumLevel)):highestLevel;
+    LevelProgression levelProgression;
+
+    levelProgression.mRadicalsProgress = progress[0][level];
+    levelProgression.mRadicalsTotal = total[0][level];
+    levelProgression.mKanjiProgress = progress[1][level];
+    levelProgression.mKanjiTotal = total[1][level];
+
+    // Cross-check what we have derived against what we have been reported, if
+    // anything
+
+    if (   fetchedEndpoint(Metrics::StudyQueueEndpoint)
+        && (studyQueue.mReviewsAvailable != mReportedStudyQueue.mReviewsAvailable)) {
+        Metrics::instance()->add(Metrics::DerivationMismatches);
+    }
+
+    if (   fetchedEndpoint(Metrics::LevelProgressionEndpoint)
+        && (   (levelProgression.mRadicalsProgress != mReportedLevelProgression.mRadicalsProgress)
+            || (levelProgression.mRadicalsTotal != mReportedLevelProgression.mRadicalsTotal)
+            || (levelProgression.mKanjiProgress != mReportedLevelProgression.mKanjiProgress)
+            || (levelProgression.mKanjiTotal != mReportedLevelProgression.mKanjiTotal))) {
+        Metrics::instance()->add(Metrics::DerivationMismatches);
+    }
+
+    if (fetchedEndpoint(Metrics::SrsDistributionEndpoint) && srsDistributionMismatch) {
+        Metrics::instance()->add(Metrics::DerivationMismatches);
+    }
+
+    // Keep track of what we have derived
+
+    mStudyQueue = studyQueue;
+    mLevelProgression = levelProgression;
+    mSrsDistribution = derivedSrsDistribution;
+}
+
+//==============================================================================
+
+void WaniKani::updateSrsDistribution(const QString &pName,
+                                     const QVariantMap &pVariantMap,
+                                     SrsDistributionInformation &pSrsDistributionInformation)
+{
+    // Update the given SRS distribution information using the given variant map
+
+    pSrsDistributionInformation.mName = pName;
+    pSrsDistributionInformation.mRadicals = pVariantMap["radicals"].toString();
+    pSrsDistributionInformation.mKanji = pVariantMap["kanji"].toString();
+    pSrsDistributionInformation.mVocabulary = pVariantMap["vocabulary"].toString();
+    pSrsDistributionInformation.mTotal = pVariantMap["total"].toString();
+}
+
+//==============================================================================
+
+std::shared_ptr<const Snapshot> WaniKani::snapshot() const
+{
+    // Return our current snapshot
+
+    return std::atomic_load(&mSnapshot);
+}
+
+//==============================================================================
+
+ItemColumns::ItemType WaniKani::itemType(quint64 pItemKey)
+{
+    // Return the type of the item which key is given (see itemKey())
+
+    return ItemColumns::ItemType(pItemKey >> 62);
+}
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -1,368 +1,631 @@
-/*******************************************************************************
-
-Copyright Alan Garny
-
-Licensed under the Apache License, Version 2.0 (the "License");
-you may not use this file except in compliance with the License.
-You may obtain a copy of the License at
-
-    http://www.apache.org/licenses/LICENSE-2.0
-
-Unless required by applicable law or agreed to in writing, software
-distributed under the License is distributed on an "AS IS" BASIS,
-WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-See the License for the specific language governing permissions and
-limitations under the License.
-
-*******************************************************************************/
-
-//==============================================================================
-// WaniKani
-//==============================================================================
-
-#pragma once
-
-//==============================================================================
-
-#include <QDateTime>
-#include <QJsonDocument>
-#include <QList>
-#include <QObject>
-#include <QPixmap>
-#include <QString>
-
-//==============================================================================
-
-class Common
-{
-public:
-    void reset();
-
-protected:
-    bool mHasData = false;
-};
-
-//==============================================================================
-
-class User : public Common
-{
-    friend class WaniKani;
-
-public:
-    QDateTime currentVacationStartedAt() const;
-    int level() const;
-    QString profileUrl() const;
-    QString userName() const;
-
-private:
-    QDateTime mCurrentVacationStartedAt;
-    int mLevel = 0;
-    QString mProfileUrl;
-    QString mUserName;
-};
-
-//==============================================================================
-
-class StudyQueue
-{
-    friend class WaniKani;
-
-public:
-    int lessonsAvailable() const;
-    int reviewsAvailable() const;
-    uint nextReviewDate() const;
-    int reviewsAvailableNextHour() const;
-    int reviewsAvailableNextDay() const;
-
-private:
-    int mLessonsAvailable = 0;
-    int mReviewsAvailable = 0;
-    uint mNextReviewDate = 0;
-    int mReviewsAvailableNextHour = 0;
-    int mReviewsAvailableNextDay = 0;
-};
-
-//==============================================================================
-
-class LevelProgression
-{
-    friend class WaniKani;
-
-public:
-    int radicalsProgress() const;
-    int radicalsTotal() const;
-    int kanjiProgress() const;
-    int kanjiTotal() const;
-
-private:
-    int mRadicalsProgress = 0;
-    int mRadicalsTotal = 0;
-    int mKanjiProgress = 0;
-    int mKanjiTotal = 0;
-};
-
-//==============================================================================
-
-class SrsDistributionInformation
-{
-    friend class WaniKani;
-
-public:
-    QString name() const;
-    QString radicals() const;
-    QString kanji() const;
-    QString vocabulary() const;
-    QString total() const;
-
-private:
-    QString mName;
-    QString mRadicals;
-    QString mKanji;
-    QString mVocabulary;
-    QString mTotal;
-};
-
-//==============================================================================
-
-class SrsDistribution
-{
-    friend class WaniKani;
-
-public:
-    SrsDistributionInformation apprentice() const;
-    SrsDistributionInformation guru() const;
-    SrsDistributionInformation master() const;
-    SrsDistributionInformation enlightened() const;
-    SrsDistributionInformation burned() const;
-
-private:
-    SrsDistributionInformation mApprentice;
-    SrsDistributionInformation mGuru;
-    SrsDistributionInformation mMaster;
-    SrsDistributionInformation mEnlightened;
-    SrsDistributionInformation mBurned;
-};
-
-//==============================================================================
-
-class Item
-{
-    friend class WaniKani;
-
-public:
-    QChar character() const;
-    QString meaning() const;
-    int level() const;
-
-private:
-    QChar mCharacter;
-    QString mMeaning;
-    int mLevel = 0;
-};
-
-//==============================================================================
-
-class UserSpecific
-{
-    friend class WaniKani;
-
-public:
-    QString srs() const;
-    int srsNumeric() const;
-    uint unlockedDate() const;
-    uint availableDate() const;
-    bool burned() const;
-    uint burnedDate() const;
-    int meaningCorrect() const;
-    int meaningIncorrect() const;
-    int meaningMaxStreak() const;
-    int meaningCurrentStreak() const;
-    int readingCorrect() const;
-    int readingIncorrect() const;
-    int readingMaxStreak() const;
-    int readingCurrentStreak() const;
-    QString meaningNote() const;
-    QString userSynonyms() const;
-
-private:
-    QString mSrs;
-    int mSrsNumeric = 0;
-    uint mUnlockedDate = 0;
-    uint mAvailableDate = 0;
-    bool mBurned = false;
-    uint mBurnedDate = 0;
-    int mMeaningCorrect = 0;
-    int mMeaningIncorrect = 0;
-    int mMeaningMaxStreak = 0;
-    int mMeaningCurrentStreak = 0;
-    int mReadingCorrect = 0;
-    int mReadingIncorrect = 0;
-    int mReadingMaxStreak = 0;
-    int mReadingCurrentStreak = 0;
-    QString mMeaningNote;
-    QString mUserSynonyms;
-};
-
-//==============================================================================
-
-class Radical : public Item
-{
-    friend class WaniKani;
-
-public:
-    QString image() const;
-    UserSpecific userSpecific() const;
-
-private:
-    QString mImage;
-    UserSpecific mUserSpecific;
-};
-
-//==============================================================================
-
-typedef QList<Radical> Radicals;
-
-//==============================================================================
-
-class ExtraUserSpecific : public UserSpecific
-{
-    friend class WaniKani;
-
-public:
-    QString readingNote() const;
-
-private:
-    QString mReadingNote;
-};
-
-//==============================================================================
-
-class Kanji : public Item
-{
-    friend class WaniKani;
-
-public:
-    QString onyomi() const;
-    QString kunyomi() const;
-    QString nanori() const;
-    QString imporantReading() const;
-    ExtraUserSpecific userSpecific() const;
-
-private:
-    QString mOnyomi;
-    QString mKunyomi;
-    QString mNanori;
-    QString mImportantReading;
-    ExtraUserSpecific mUserSpecific;
-};
-
-//==============================================================================
-
-typedef QList<Kanji> Kanjis;
-
-//==============================================================================
-
-class Vocabulary : public Item
-{
-    friend class WaniKani;
-
-public:
-    QString kana() const;
-    ExtraUserSpecific userSpecific() const;
-
-private:
-    QString mKana;
-    ExtraUserSpecific mUserSpecific;
-};
-
-//==============================================================================
-
-typedef QList<Vocabulary> Vocabularies;
-
-//==============================================================================
-
-class QNetworkAccessManager;
-class QNetworkReply;
-
-//==============================================================================
-
-class WaniKani : public QObject
-{
-    Q_OBJECT
-
-public:
-    explicit WaniKani();
-    ~WaniKani();
-
-    void setApiKeyAndToken(const QString &pApiKey, const QString &pApiToken);
-
-    User user() const;
-    StudyQueue studyQueue() const;
-    LevelProgression levelProgression() const;
-    SrsDistribution srsDistribution() const;
-    Radicals radicals() const;
-    Kanjis kanjis() const;
-    Vocabularies vocabularies() const;
-
-    void forceUpdate();
-
-private:
-    QString mApiKey;
-    QString mApiToken;
-
-    User mUser;
-    StudyQueue mStudyQueue;
-    LevelProgression mLevelProgression;
-    SrsDistribution mSrsDistribution;
-    Radicals mRadicals;
-    Kanjis mKanjis;
-    Vocabularies mVocabularies;
-
-    QNetworkAccessManager *mNetworkAccessManager;
-
-    QJsonDocument mUserResponse;
-    QJsonDocument mStudyQueueResponse;
-    QJsonDocument mLevelProgressionResponse;
-    QJsonDocument mSrsDistributionResponse;
-    QJsonDocument mRadicalsResponse;
-    QJsonDocument mKanjiResponse;
-    QJsonDocument mVocabularyResponse;
-
-    int mNbOfReplies = 0;
-    int mNbOfNeededReplies = 7;
-
-    QNetworkReply * waniKaniNetworkReply(const QString &pRequest);
-    QNetworkReply * waniKaniV2NetworkReply(const QString &pRequest);
-    QJsonDocument waniKaniJsonResponse(QNetworkReply *pNetworkReply);
-
-    bool validJsonDocument(const QJsonDocument &pJsonDocument);
-
-    void checkNbOfReplies();
-
-    void doUpdate(bool pForce = false);
-
-    void updateSrsDistribution(const QString &pName,
-                               const QVariantMap &pVariantMap,
-                               SrsDistributionInformation &pSrsDistributionInformation);
-
-signals:
-    void updated();
-    void error();
-
-public slots:
-    void update();
-
-private slots:
-    void userReply();
-
-    void studyQueueReply();
-    void levelProgressionReply();
-    void srsDistributionReply();
-    void radicalsReply();
-    void kanjiReply();
-    void vocabularyReply();
-};
-
-//==============================================================================
-// End of file
-//==============================================================================
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// WaniKani
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "metrics.h"
+
+//==============================================================================
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QJsonDocument>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QPixmap>
+#include <QSslConfiguration>
+#include <QString>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+//==============================================================================
+
+#include <memory>
+
+//==============================================================================
+
+class Common
+{
+public:
+    void reset();
+
+protected:
+    bool mHasData = false;
+};
+
+//==============================================================================
+
+class User : public Common
+{
+    friend class WaniKani;
+    friend class AggregationBenchmark;
+
+public:
+    QDateTime currentVacationStartedAt() const;
+    int level() const;
+    QString profileUrl() const;
+    QString userName() const;
+
+private:
+    QDateTime mCurrentVacationStartedAt;
+    int mLevel = 0;
+    QString mProfileUrl;
+    QString mUserName;
+};
+
+//==============================================================================
+
+class StudyQueue
+{
+    friend class WaniKani;
+
+public:
+    int lessonsAvailable() const;
+    int reviewsAvailable() const;
+    uint nextReviewDate() const;
+    int reviewsAvailableNextHour() const;
+    int reviewsAvailableNextDay() const;
+
+private:
+    int mLessonsAvailable = 0;
+    int mReviewsAvailable = 0;
+    uint mNextReviewDate = 0;
+    int mReviewsAvailableNextHour = 0;
+    int mReviewsAvailableNextDay = 0;
+};
+
+//==============================================================================
+
+class LevelProgression
+{
+    friend class WaniKani;
+
+public:
+    int radicalsProgress() const;
+    int radicalsTotal() const;
+    int kanjiProgress() const;
+    int kanjiTotal() const;
+
+private:
+    int mRadicalsProgress = 0;
+    int mRadicalsTotal = 0;
+    int mKanjiProgress = 0;
+    int mKanjiTotal = 0;
+};
+
+//==============================================================================
+
+class SrsDistributionInformation
+{
+    friend class WaniKani;
+
+public:
+    QString name() const;
+    QString radicals() const;
+    QString kanji() const;
+    QString vocabulary() const;
+    QString total() const;
+
+private:
+    QString mName;
+    QString mRadicals;
+    QString mKanji;
+    QString mVocabulary;
+    QString mTotal;
+};
+
+//==============================================================================
+
+class SrsDistribution
+{
+    friend class WaniKani;
+
+public:
+    SrsDistributionInformation apprentice() const;
+    SrsDistributionInformation guru() const;
+    SrsDistributionInformation master() const;
+    SrsDistributionInformation enlightened() const;
+    SrsDistributionInformation burned() const;
+
+private:
+    SrsDistributionInformation mApprentice;
+    SrsDistributionInformation mGuru;
+    SrsDistributionInformation mMaster;
+    SrsDistributionInformation mEnlightened;
+    SrsDistributionInformation mBurned;
+};
+
+//==============================================================================
+
+class StringArena;
+
+//==============================================================================
+
+class ArenaString
+{
+    friend class StringArena;
+
+public:
+    QStringRef ref() const;
+    QString toString() const;
+
+private:
+    std::shared_ptr<const StringArena> mArena;
+    int mPosition = 0;
+    int mSize = 0;
+};
+
+//==============================================================================
+
+class StringArena : public std::enable_shared_from_this<StringArena>
+{
+    friend class ArenaString;
+
+public:
+    ArenaString add(const QString &pString);
+
+    void squeeze();
+
+private:
+    QString mStrings;
+    QHash<QStringRef, int> mPositions;
+};
+
+//==============================================================================
+
+class Item
+{
+    friend class WaniKani;
+
+public:
+    int id() const;
+    QStringRef characters() const;
+    QStringRef meaning() const;
+    int level() const;
+
+private:
+    int mId = 0;
+    ArenaString mCharacters;
+    ArenaString mMeaning;
+    int mLevel = 0;
+};
+
+//==============================================================================
+
+class UserSpecific
+{
+    friend class WaniKani;
+
+public:
+    QString srs() const;
+    int srsNumeric() const;
+    uint unlockedDate() const;
+    uint availableDate() const;
+    bool burned() const;
+    uint burnedDate() const;
+    int meaningCorrect() const;
+    int meaningIncorrect() const;
+    int meaningMaxStreak() const;
+    int meaningCurrentStreak() const;
+    int readingCorrect() const;
+    int readingIncorrect() const;
+    int readingMaxStreak() const;
+    int readingCurrentStreak() const;
+    QStringRef meaningNote() const;
+    QStringRef userSynonyms() const;
+
+private:
+    QString mSrs;
+    int mSrsNumeric = 0;
+    uint mUnlockedDate = 0;
+    uint mAvailableDate = 0;
+    bool mBurned = false;
+    uint mBurnedDate = 0;
+    int mMeaningCorrect = 0;
+    int mMeaningIncorrect = 0;
+    int mMeaningMaxStreak = 0;
+    int mMeaningCurrentStreak = 0;
+    int mReadingCorrect = 0;
+    int mReadingIncorrect = 0;
+    int mReadingMaxStreak = 0;
+    int mReadingCurrentStreak = 0;
+    ArenaString mMeaningNote;
+    ArenaString mUserSynonyms;
+};
+
+//==============================================================================
+
+class Radical : public Item
+{
+    friend class WaniKani;
+
+public:
+    QStringRef image() const;
+    const UserSpecific & userSpecific() const;
+
+private:
+    ArenaString mImage;
+    UserSpecific mUserSpecific;
+};
+
+//==============================================================================
+
+typedef QList<Radical> Radicals;
+
+//==============================================================================
+
+class ExtraUserSpecific : public UserSpecific
+{
+    friend class WaniKani;
+
+public:
+    QStringRef readingNote() const;
+
+private:
+    ArenaString mReadingNote;
+};
+
+//==============================================================================
+
+class Kanji : public Item
+{
+    friend class WaniKani;
+
+public:
+    QChar character() const;
+    QStringRef onyomi() const;
+    QStringRef kunyomi() const;
+    QStringRef nanori() const;
+    QStringRef imporantReading() const;
+    const ExtraUserSpecific & userSpecific() const;
+
+private:
+    ArenaString mOnyomi;
+    ArenaString mKunyomi;
+    ArenaString mNanori;
+    ArenaString mImportantReading;
+    ExtraUserSpecific mUserSpecific;
+};
+
+//==============================================================================
+
+typedef QList<Kanji> Kanjis;
+
+//==============================================================================
+
+class Vocabulary : public Item
+{
+    friend class WaniKani;
+
+public:
+    QStringRef kana() const;
+    const ExtraUserSpecific & userSpecific() const;
+
+private:
+    ArenaString mKana;
+    ExtraUserSpecific mUserSpecific;
+};
+
+//==============================================================================
+
+typedef QList<Vocabulary> Vocabularies;
+
+//==============================================================================
+
+class ItemColumns
+{
+    friend class WaniKani;
+
+public:
+    enum ItemType {
+        RadicalType,
+        KanjiType,
+        VocabularyType,
+        NbOfItemTypes
+    };
+
+    int count() const;
+
+    const QVector<int> & types() const;
+    const QVector<int> & levels() const;
+    const QVector<int> & srsLevels() const;
+    const QVector<uint> & unlockedDates() const;
+    const QVector<uint> & availableDates() const;
+    const QVector<int> & correct() const;
+    const QVector<int> & incorrect() const;
+    const QVector<QChar> & characters() const;
+    const QVector<QString> & srs() const;
+
+private:
+    QVector<int> mTypes;
+    QVector<int> mLevels;
+    QVector<int> mSrsLevels;
+    QVector<uint> mUnlockedDates;
+    QVector<uint> mAvailableDates;
+    QVector<int> mCorrect;
+    QVector<int> mIncorrect;
+    QVector<QChar> mCharacters;
+    QVector<QString> mSrs;
+
+    void reserve(int pSize);
+    void add(ItemType pType, const Item &pItem,
+             const UserSpecific &pUserSpecific, int pCorrect, int pIncorrect,
+             QChar pCharacter);
+};
+
+//==============================================================================
+
+class Snapshot
+{
+    friend class WaniKani;
+    friend class AggregationBenchmark;
+
+public:
+    const User & user() const;
+    const StudyQueue & studyQueue() const;
+    const LevelProgression & levelProgression() const;
+    const SrsDistribution & srsDistribution() const;
+    const Radicals & radicals() const;
+    const Kanjis & kanjis() const;
+    const Vocabularies & vocabularies() const;
+    const ItemColumns & itemColumns() const;
+
+private:
+    User mUser;
+    StudyQueue mStudyQueue;
+    LevelProgression mLevelProgression;
+    SrsDistribution mSrsDistribution;
+    Radicals mRadicals;
+    Kanjis mKanjis;
+    Vocabularies mVocabularies;
+    ItemColumns mItemColumns;
+};
+
+//==============================================================================
+
+template<typename T>
+struct ItemsResponse
+{
+    bool valid = false;
+    T items;
+};
+
+//==============================================================================
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QNetworkRequest;
+
+//==============================================================================
+
+class WaniKani : public QObject
+{
+    Q_OBJECT
+
+    friend class AggregationBenchmark;
+
+public:
+    explicit WaniKani();
+    ~WaniKani() override;
+
+    void setApiKeyAndToken(const QString &pApiKey, const QString &pApiToken);
+
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+    static ItemColumns::ItemType itemType(quint64 pItemKey);
+
+    void forceUpdate();
+
+private:
+    QThread mThread;
+    QThreadPool mThreadPool;
+
+    std::shared_ptr<const Snapshot> mSnapshot;
+
+    QString mApiKey;
+    QString mApiToken;
+
+    User mUser;
+    StudyQueue mStudyQueue;
+    StudyQueue mReportedStudyQueue;
+    LevelProgression mLevelProgression;
+    LevelProgression mReportedLevelProgression;
+    SrsDistribution mSrsDistribution;
+    SrsDistribution mReportedSrsDistribution;
+    Radicals mRadicals;
+    Kanjis mKanjis;
+    Vocabularies mVocabularies;
+
+    QNetworkAccessManager *mNetworkAccessManager;
+
+    QElapsedTimer mElapsedTimer;
+
+    QMap<QString, QByteArray> mSessionTickets;
+
+    quint64 mGeneration = 0;
+    QList<QNetworkReply *> mNetworkReplies;
+
+    enum RequestPriority {
+        HighPriority,
+        NormalPriority,
+        LowPriority
+    };
+
+    typedef void (WaniKani::*ReplySlot)();
+
+    struct V2Request
+    {
+        QString request;
+        RequestPriority priority;
+        ReplySlot slot;
+        qint64 queueTime;
+    };
+
+    QList<V2Request> mV2Requests;
+    QMap<QNetworkReply *, V2Request> mV2NetworkReplies;
+    double mV2Tokens;
+    qint64 mV2TokensTime = 0;
+    int mV2RateLimitRemaining;
+    qint64 mV2RateLimitReset = 0;
+    bool mV2RequestsScheduled = false;
+
+    qint64 mUpdateTime = 0;
+    qint64 mFetchTimes[Metrics::NbOfEndpoints] = {};
+    QByteArray mResponseDigests[Metrics::NbOfEndpoints];
+    bool mValidResponses[Metrics::NbOfEndpoints] = {};
+    bool mRequestedEndpoints[Metrics::NbOfEndpoints] = {};
+
+    QMap<int, Radical> mRadicalSubjects;
+    QMap<int, Kanji> mKanjiSubjects;
+    QMap<int, Vocabulary> mVocabularySubjects;
+    QString mSubjectsUpdatedAt;
+    QString mNewSubjectsUpdatedAt;
+    QMap<int, UserSpecific> mAssignments;
+    QString mAssignmentsUpdatedAt;
+    QString mNewAssignmentsUpdatedAt;
+    QMap<int, UserSpecific> mReviewStatistics;
+    QString mReviewStatisticsUpdatedAt;
+    QString mNewReviewStatisticsUpdatedAt;
+    bool mSubjectsOrAssignmentsChanged = false;
+
+    QFuture<ItemsResponse<Radicals>> mRadicalsFuture;
+    QFuture<ItemsResponse<Kanjis>> mKanjisFuture;
+    QFuture<ItemsResponse<Vocabularies>> mVocabulariesFuture;
+    bool mChanged = false;
+    bool mForcedUpdatePending = false;
+
+    QSslConfiguration sslConfiguration(const QString &pHost) const;
+
+    QNetworkReply * networkReply(QNetworkRequest &pNetworkRequest);
+    bool staleNetworkReply(QNetworkReply *pNetworkReply);
+
+    bool updating() const;
+    void cancel();
+
+    bool usedEndpoint(Metrics::Endpoint pEndpoint) const;
+    bool freshEndpoint(Metrics::Endpoint pEndpoint) const;
+    QNetworkReply * requestEndpoint(Metrics::Endpoint pEndpoint);
+    void requestStaleEndpoints(bool pStudyQueueChanged);
+
+    QNetworkReply * waniKaniNetworkReply(const QString &pRequest);
+    QNetworkReply * waniKaniV2NetworkReply(const QString &pRequest);
+    void requestV2(const QString &pRequest, RequestPriority pPriority,
+                   ReplySlot pSlot);
+    static QString updatedAfterRequest(const QString &pRequest,
+                                       const QString &pUpdatedAt);
+    static QString nextPageRequest(const QVariantMap &pCollectionMap);
+    void sendV2Requests();
+    bool waniKaniResponse(QNetworkReply *pNetworkReply,
+                          Metrics::Endpoint pEndpoint, QByteArray &pResponse);
+    static QJsonDocument jsonDocument(Metrics::Endpoint pEndpoint,
+                                      const QByteArray &pResponse);
+    bool validResponse(Metrics::Endpoint pEndpoint, bool pValid);
+    bool waniKaniJsonResponse(QNetworkReply *pNetworkReply,
+                              Metrics::Endpoint pEndpoint,
+                              QJsonDocument &pJsonDocument);
+
+    static bool validJsonDocument(const QJsonDocument &pJsonDocument);
+
+    static uint epochTime(const QVariant &pDateTime);
+
+    static QString subjectsFileName();
+    void loadSubjects();
+    bool saveSubjects() const;
+    UserSpecific userSpecific(int pSubjectId) const;
+    void joinSubjectsAndAssignments();
+
+    static ItemsResponse<Radicals> parseRadicals(const QByteArray &pResponse);
+    static ItemsResponse<Kanjis> parseKanjis(const QByteArray &pResponse);
+    static ItemsResponse<Vocabularies> parseVocabularies(const QByteArray &pResponse);
+
+    static ItemColumns itemColumns(const Radicals &pRadicals,
+                                   const Kanjis &pKanjis,
+                                   const Vocabularies &pVocabularies);
+
+    template<typename T>
+    void joinItems(QFuture<ItemsResponse<T>> &pFuture,
+                   Metrics::Endpoint pEndpoint, T &pItems);
+
+    bool fetchedEndpoint(Metrics::Endpoint pEndpoint) const;
+
+    void deriveInformation();
+
+    void checkNbOfReplies();
+    void publishSnapshot();
+    void emitChanges(const Snapshot &pOldSnapshot,
+                     const Snapshot &pNewSnapshot);
+    void releaseMemory();
+
+    void updateSrsDistribution(const QString &pName,
+                               const QVariantMap &pVariantMap,
+                               SrsDistributionInformation &pSrsDistributionInformation);
+
+signals:
+    void userChanged();
+    void studyQueueChanged();
+    void levelProgressionChanged();
+    void srsDistributionChanged();
+    void itemsChanged(const QVector<quint64> &pChangedItems);
+
+    void updated();
+    void unchanged();
+    void error();
+
+public slots:
+    void update();
+
+    void preconnect();
+
+    void stop();
+
+private slots:
+    void started();
+
+    void doSetApiKeyAndToken(const QString &pApiKey, const QString &pApiToken);
+    void doUpdate(bool pForce);
+
+    void networkReplyEncrypted();
+
+    void v2Reply();
+
+    void userReply();
+
+    void studyQueueReply();
+    void levelProgressionReply();
+    void srsDistributionReply();
+    void radicalsReply();
+    void kanjiReply();
+    void vocabularyReply();
+    void subjectsReply();
+    void assignmentsReply();
+    void reviewStatisticsReply();
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
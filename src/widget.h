@@ -1,269 +1,304 @@
-/*******************************************************************************
-
-Copyright Alan Garny
-
-Licensed under the Apache License, Version 2.0 (the "License");
-you may not use this file except in compliance with the License.
-You may obtain a copy of the License at
-
-    http://www.apache.org/licenses/LICENSE-2.0
-
-Unless required by applicable law or agreed to in writing, software
-distributed under the License is distributed on an "AS IS" BASIS,
-WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-See the License for the specific language governing permissions and
-limitations under the License.
-
-*******************************************************************************/
-
-//==============================================================================
-// Widget
-//==============================================================================
-
-#pragma once
-
-//==============================================================================
-
-#include "wanikani.h"
-
-//==============================================================================
-
-#include <QDateTime>
-#include <QLabel>
-#include <QMap>
-#include <QSystemTrayIcon>
-#include <QTimer>
-#include <QWidget>
-
-//==============================================================================
-
-namespace Ui {
-    class Widget;
-}
-
-//==============================================================================
-
-class QPushButton;
-
-//==============================================================================
-
-class Widget;
-
-//==============================================================================
-
-class LabelWidget : public QLabel
-{
-    Q_OBJECT
-
-public:
-    explicit LabelWidget(QWidget *pParent);
-
-protected:
-    void mouseMoveEvent(QMouseEvent *pEvent) override;
-};
-
-//==============================================================================
-
-class ProgressBarWidget : public QWidget
-{
-    Q_OBJECT
-
-public:
-    explicit ProgressBarWidget(QWidget *pParent);
-
-    void setValue(double pValue);
-    void setColor(const QColor &pColor);
-
-protected:
-    void mouseMoveEvent(QMouseEvent *pEvent) override;
-    void paintEvent(QPaintEvent *pEvent) override;
-
-private:
-    double mValue;
-
-    QColor mColor;
-};
-
-//==============================================================================
-
-struct ReviewsTimeLineData
-{
-    QString date;
-
-    double xStart;
-    double xEnd;
-
-    double yStart;
-    double yEnd;
-
-    int currentRadicals;
-    int allRadicals;
-
-    int currentKanji;
-    int allKanji;
-
-    int currentVocabulary;
-    int allVocabulary;
-};
-
-//==============================================================================
-
-class ReviewsTimeLineWidget : public QWidget
-{
-    Q_OBJECT
-
-public:
-    explicit ReviewsTimeLineWidget(QWidget *pParent);
-
-    void update(int pRange);
-
-    void setRadicalsColor(const QColor &pRadicalsColor);
-    void setKanjiColor(const QColor &pKanjiColor);
-    void setVocabularyColor(const QColor &pVocabularyColor);
-
-protected:
-    void mouseMoveEvent(QMouseEvent *pEvent) override;
-    void paintEvent(QPaintEvent *pEvent) override;
-
-private:
-    Widget *mWidget;
-
-    int mRange;
-
-    QColor mRadicalsColor;
-    QColor mKanjiColor;
-    QColor mVocabularyColor;
-
-    QList<ReviewsTimeLineData> mData;
-};
-
-//==============================================================================
-
-typedef QMap<QDateTime, int> Reviews;
-
-//==============================================================================
-
-class Widget : public QWidget
-{
-    Q_OBJECT
-
-public:
-    explicit Widget();
-
-    QDateTime now() const;
-
-    Reviews currentRadicalsReviews() const;
-    Reviews allRadicalsReviews() const;
-
-    Reviews currentKanjiReviews() const;
-    Reviews allKanjiReviews() const;
-
-    Reviews currentVocabularyReviews() const;
-    Reviews allVocabularyReviews() const;
-
-protected:
-    bool event(QEvent *pEvent) override;
-#ifdef Q_OS_MAC
-    void changeEvent(QEvent *pEvent) override;
-    void closeEvent(QCloseEvent *pEvent) override;
-#endif
-#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
-    void keyPressEvent(QKeyEvent *pEvent) override;
-#endif
-
-private:
-    Ui::Widget *mGui;
-
-    bool mInitializing;
-
-    WaniKani mWaniKani;
-
-    QString mFileName;
-
-    QTimer mWaniKaniTimer;
-
-    QSystemTrayIcon mTrayIcon;
-
-    QMap<QPushButton *, QRgb> mColors;
-
-    QMap<QChar, QString> mCurrentKanjiState;
-    QMap<QChar, QString> mAllKanjiState;
-    QMap<QChar, QString> mOldKanjiState;
-
-    bool mNeedToCheckWallpaper;
-
-    Reviews mCurrentRadicalsReviews;
-    Reviews mAllRadicalsReviews;
-
-    Reviews mCurrentKanjiReviews;
-    Reviews mAllKanjiReviews;
-
-    Reviews mCurrentVocabularyReviews;
-    Reviews mAllVocabularyReviews;
-
-    QDateTime mNow;
-    qint64 mLevelStartTime;
-
-    QList<qint64> mRadicalGuruTimes;
-    QList<qint64> mKanjiGuruTimes;
-
-    void retrieveSettings(bool pResetSettings = false);
-
-    void setPushButtonColor(QPushButton *pPushButton, QRgb pColor);
-
-    QColor color(int pRow, int pColumn) const;
-
-    void updateInterval(int pInterval);
-
-    QString iconDataUri(const QString &pIcon, int pWidth = -1, int pHeight = -1,
-                        QIcon::Mode pMode = QIcon::Normal);
-
-    void updateSrsDistributionPalettes();
-    void updateSrsDistributionInformation(QLabel *pLabel, const QString &pIcon,
-                                          const SrsDistributionInformation &pInformation);
-
-    void updateWallpaper(bool pForceUpdate = false);
-
-    void setWallpaper();
-
-    void determineReviews(const Reviews &pCurrentReviews,
-                          const Reviews &pAllReviews, QDateTime &pNextDateTime,
-                          qint64 &pDiff, int *pNbOfReviews);
-
-    qint64 guruTime(int pSrsLevel = 0, qint64 pNextReview = 0);
-
-    void resetInternals(bool pVisible = true);
-
-private slots:
-    void on_apiKeyValue_returnPressed();
-    void on_apiTokenValue_returnPressed();
-
-    void on_intervalSpinBox_valueChanged(int pInterval);
-    void on_forceUpdateButton_clicked();
-
-    void on_fontComboBox_currentTextChanged(const QString &pFontName);
-    void on_boldFontCheckBox_clicked();
-    void on_italicsFontCheckBox_clicked();
-
-    void on_swapPushButton_clicked();
-
-    void on_resetAllPushButton_clicked();
-    void on_closeToolButton_clicked();
-
-    void waniKaniUpdated();
-    void waniKaniError();
-
-    void trayIconActivated();
-
-    void updateLevels();
-
-    void updateTimeRelatedInformation();
-
-    void updatePushButtonColor();
-
-    void checkWallpaper();
-};
-
-//==============================================================================
-// End of file
-//==============================================================================
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Widget
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "aggregation.h"
+#include "history.h"
+#include "levelupprojection.h"
+#include "statsserver.h"
+#include "wanikani.h"
+#include "workloadforecast.h"
+
+//==============================================================================
+
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QJsonObject>
+#include <QLabel>
+#include <QMap>
+#include <QSystemTrayIcon>
+#include <QThreadPool>
+#include <QTimer>
+#include <QWidget>
+
+//==============================================================================
+
+namespace Ui {
+    class Widget;
+}
+
+//==============================================================================
+
+class QPushButton;
+
+//==============================================================================
+
+class Widget;
+
+//==============================================================================
+
+class LabelWidget : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit LabelWidget(QWidget *pParent);
+
+protected:
+    void mouseMoveEvent(QMouseEvent *pEvent) override;
+};
+
+//==============================================================================
+
+class ProgressBarWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ProgressBarWidget(QWidget *pParent);
+
+    void setValue(double pValue);
+    void setColor(const QColor &pColor);
+
+protected:
+    void mouseMoveEvent(QMouseEvent *pEvent) override;
+    void paintEvent(QPaintEvent *pEvent) override;
+
+private:
+    double mValue;
+
+    QColor mColor;
+};
+
+//==============================================================================
+
+struct ReviewsTimeLineData
+{
+    qint64 time;
+
+    double xStart;
+    double xEnd;
+
+    double yStart;
+    double yEnd;
+
+    int currentRadicals;
+    int allRadicals;
+
+    int currentKanji;
+    int allKanji;
+
+    int currentVocabulary;
+    int allVocabulary;
+};
+
+//==============================================================================
+
+class ReviewsTimeLineWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ReviewsTimeLineWidget(QWidget *pParent);
+
+    void update(int pRange);
+
+    void setRadicalsColor(const QColor &pRadicalsColor);
+    void setKanjiColor(const QColor &pKanjiColor);
+    void setVocabularyColor(const QColor &pVocabularyColor);
+
+protected:
+    void mouseMoveEvent(QMouseEvent *pEvent) override;
+    void paintEvent(QPaintEvent *pEvent) override;
+
+private:
+    Widget *mWidget;
+
+    int mRange;
+
+    QColor mRadicalsColor;
+    QColor mKanjiColor;
+    QColor mVocabularyColor;
+
+    QList<ReviewsTimeLineData> mData;
+};
+
+//==============================================================================
+
+class Widget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit Widget();
+
+    qint64 now() const;
+
+    Reviews currentRadicalsReviews() const;
+    Reviews allRadicalsReviews() const;
+
+    Reviews currentKanjiReviews() const;
+    Reviews allKanjiReviews() const;
+
+    Reviews currentVocabularyReviews() const;
+    Reviews allVocabularyReviews() const;
+
+    const WorkloadForecast & workloadForecast() const;
+
+protected:
+    bool event(QEvent *pEvent) override;
+#ifdef Q_OS_MAC
+    void changeEvent(QEvent *pEvent) override;
+    void closeEvent(QCloseEvent *pEvent) override;
+#endif
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+    void keyPressEvent(QKeyEvent *pEvent) override;
+#endif
+
+private:
+    Ui::Widget *mGui;
+
+    bool mInitializing;
+
+    WaniKani mWaniKani;
+    std::shared_ptr<const Snapshot> mSnapshot;
+
+    bool mUserChanged;
+    bool mLevelProgressionChanged;
+    bool mSrsDistributionChanged;
+    bool mItemsChanged;
+    bool mKanjiChanged;
+
+    StatsServer mStatsServer;
+
+    QString mFileName;
+
+    QTimer mWaniKaniTimer;
+    QTimer mPreconnectTimer;
+    QTimer mDiagnosticsTimer;
+
+    QSystemTrayIcon mTrayIcon;
+
+    QMap<QPushButton *, QRgb> mColors;
+
+    QHash<QString, QString> mIconDataUris;
+
+    QMap<QChar, QString> mOldKanjiState;
+
+    bool mNeedToCheckWallpaper;
+
+    int mNbOfIdleUpdates;
+
+    qint64 mNow;
+
+    Aggregation mAggregation;
+    LevelUpProjection mLevelUpProjection;
+    WorkloadForecast mWorkloadForecast;
+
+    History mHistory;
+    QJsonObject mHistoryStats;
+    QFutureWatcher<QJsonObject> mHistoryWatcher;
+    QThreadPool mHistoryThreadPool;
+
+    void retrieveSettings(bool pResetSettings = false);
+
+    void setPushButtonColor(QPushButton *pPushButton, QRgb pColor);
+
+    QColor color(int pRow, int pColumn) const;
+
+    void scheduleUpdate(bool pAdaptive = true);
+    void startPreconnectTimer();
+
+    QString iconDataUri(const QString &pIcon, int pWidth = -1, int pHeight = -1,
+                        QIcon::Mode pMode = QIcon::Normal);
+
+    void updateSrsDistributionPalettes();
+    void updateSrsDistributionInformation(QLabel *pLabel, const QString &pIcon,
+                                          const SrsDistributionInformation &pInformation);
+
+    void updateWallpaper(bool pForceUpdate = false);
+
+    void setWallpaper();
+
+    void determineReviews(const Reviews &pCurrentReviews,
+                          const Reviews &pAllReviews, qint64 &pNextTime,
+                          qint64 &pDiff, int *pNbOfReviews);
+
+    void updateWorkloadForecast();
+
+    void resetInternals(bool pVisible = true);
+
+    void publishStats();
+
+private slots:
+    void on_apiKeyValue_returnPressed();
+    void on_apiTokenValue_returnPressed();
+
+    void on_intervalSpinBox_valueChanged(int pInterval);
+    void on_forceUpdateButton_clicked();
+
+    void on_fontComboBox_currentTextChanged(const QString &pFontName);
+    void on_boldFontCheckBox_clicked();
+    void on_italicsFontCheckBox_clicked();
+
+    void on_swapPushButton_clicked();
+
+    void on_lessonsPerDaySpinBox_valueChanged(int pLessonsPerDay);
+    void on_accuracySpinBox_valueChanged(int pAccuracy);
+
+    void on_diagnosticsCheckBox_toggled(bool pChecked);
+
+    void on_resetAllPushButton_clicked();
+    void on_closeToolButton_clicked();
+
+    void waniKaniUserChanged();
+    void waniKaniLevelProgressionChanged();
+    void waniKaniSrsDistributionChanged();
+    void waniKaniItemsChanged(const QVector<quint64> &pChangedItems);
+    void waniKaniUpdated();
+    void waniKaniUnchanged();
+    void waniKaniError();
+
+    void historyAppended();
+
+    void trayIconActivated();
+
+    void updateLevels();
+
+    void updateTimeRelatedInformation();
+
+    void updatePushButtonColor();
+
+    void updateWaniKani();
+
+    void checkWallpaper();
+
+    void updateDiagnostics();
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,282 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Workload forecast
+//==============================================================================
+
+#include "workloadforecast.h"
+
+//==============================================================================
+
+#include <QtConcurrentMap>
+
+//==============================================================================
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+
+static const int GuruLevel = 5;
+static const int BurnedLevel = 9;
+
+static const int SrsIntervals[2][8] = { { 4, 8, 23, 47, 167, 335, 719, 2879 },
+                                        { 2, 4, 8, 23, 167, 335, 719, 2879 } };
+
+//==============================================================================
+
+void WorkloadForecast::ItemStates::clear()
+{
+    // Clear our item states
+
+    levels.clear();
+    srsLevels.clear();
+    availableDates.clear();
+    unlocked.clear();
+}
+
+//==============================================================================
+
+void WorkloadForecast::ItemStates::add(int pLevel, int pSrsLevel,
+                                       uint pUnlockedDate, uint pAvailableDate)
+{
+    // Add the state of an item
+
+    levels << pLevel;
+    srsLevels << pSrsLevel;
+    availableDates << pAvailableDate;
+    unlocked << (pUnlockedDate != 0);
+}
+
+//==============================================================================
+
+WorkloadForecast::WorkloadForecast() :
+    mStartTime(0),
+    mReviews(QVector<double>(NbOfHours))
+{
+}
+
+//==============================================================================
+
+void WorkloadForecast::reset()
+{
+    // Reset ourselves
+
+    for (auto &itemStates : mItemStates) {
+        itemStates.clear();
+    }
+
+    mReviews.fill(0.0);
+}
+
+//==============================================================================
+
+void WorkloadForecast::add(ItemColumns::ItemType pType, int pLevel,
+                           int pSrsLevel, uint pUnlockedDate,
+                           uint pAvailableDate)
+{
+    // Keep track of the state of the given item
+
+    mItemStates[pType].add(pLevel, pSrsLevel, pUnlockedDate, pAvailableDate);
+}
+
+//==============================================================================
+
+void WorkloadForecast::forecast(qint64 pNowTime, double pAccuracy,
+                                int pNbOfLessonsPerDay)
+{
+    // Make sure that our forecast starts at the top of the current hour
+    // Note: an overdue review is accounted for at our start time, so we need
+    //       to forecast again once the hour has changed...
+
+    mStartTime = pNowTime-pNowTime%3600;
+
+    // Retrieve all our lessons, i.e. the items that we have yet to start, and
+    // schedule them, a given number per day, starting with the ones that are
+    // already unlocked and then going through the others level by level
+    // Note: we don't know when locked items will be unlocked, so we assume
+    //       that we keep up with our lessons...
+
+    QVector<Lesson> lessons;
+
+    for (int i = 0; i < ItemColumns::NbOfItemTypes; ++i) {
+        const ItemStates &itemStates = mItemStates[i];
+
+        for (int j = 0, jMax = itemStates.srsLevels.count(); j < jMax; ++j) {
+            if (!itemStates.srsLevels[j]) {
+                lessons << Lesson { itemStates.unlocked[j], itemStates.levels[j], i, j };
+            }
+        }
+    }
+
+    std::sort(lessons.begin(), lessons.end(), [](const Lesson &pLesson1, const Lesson &pLesson2) {
+        return (pLesson1.unlocked != pLesson2.unlocked)?
+                   pLesson1.unlocked:
+                   (pLesson1.level != pLesson2.level)?
+                       pLesson1.level < pLesson2.level:
+                       (pLesson1.type != pLesson2.type)?
+                           pLesson1.type < pLesson2.type:
+                           pLesson1.index < pLesson2.index;
+    });
+
+    QVector<TypeForecast> typeForecasts(ItemColumns::NbOfItemTypes);
+
+    for (int i = 0; i < ItemColumns::NbOfItemTypes; ++i) {
+        // Note: a review is only passed if all its answers (i.e. meaning and,
+        //       for Kanji and vocabulary, reading) are correct...
+
+        typeForecasts[i].itemStates = &mItemStates[i];
+        typeForecasts[i].passProbability = pow(pAccuracy, (i == ItemColumns::RadicalType)?1:2);
+        typeForecasts[i].lessonHours = QVector<int>(mItemStates[i].srsLevels.count(), -1);
+    }
+
+    if (pNbOfLessonsPerDay > 0) {
+        for (int i = 0, iMax = qMin(lessons.count(), NbOfDays*pNbOfLessonsPerDay); i < iMax; ++i) {
+            const Lesson &lesson = lessons[i];
+
+            typeForecasts[lesson.type].lessonHours[lesson.index] = 24*(i/pNbOfLessonsPerDay);
+        }
+    }
+
+    // Forecast the reviews for each type of item, in parallel, and combine them
+
+    QtConcurrent::blockingMap(typeForecasts, [this](TypeForecast &pTypeForecast) {
+        forecastReviews(pTypeForecast);
+    });
+
+    mReviews.fill(0.0);
+
+    for (const auto &typeForecast : typeForecasts) {
+        for (int i = 0; i < NbOfHours; ++i) {
+            mReviews[i] += typeForecast.reviews[i];
+        }
+    }
+}
+
+//==============================================================================
+
+qint64 WorkloadForecast::startTime() const
+{
+    // Return our start time
+
+    return mStartTime;
+}
+
+//==============================================================================
+
+const QVector<double> & WorkloadForecast::reviews() const
+{
+    // Return our hourly reviews
+
+    return mReviews;
+}
+
+//==============================================================================
+
+void WorkloadForecast::forecastReviews(TypeForecast &pTypeForecast) const
+{
+    // Determine how many items of the given type are, every hour, at a given
+    // SRS level (be it for an accelerated level or not), be it because their
+    // next review is scheduled then, or because they will then be reviewed
+    // following a lesson
+    // Note: an item which review is overdue is assumed to be reviewed now...
+
+    QVector<double> items(2*BurnedLevel*NbOfHours);
+    const ItemStates &itemStates = *pTypeForecast.itemStates;
+
+    for (int i = 0, iMax = itemStates.srsLevels.count(); i < iMax; ++i) {
+        int srsLevel = itemStates.srsLevels[i];
+        int accelerated = itemStates.levels[i] <= 2;
+
+        if (srsLevel >= BurnedLevel) {
+            continue;
+        }
+
+        if (srsLevel) {
+            if (itemStates.availableDates[i]) {
+                qint64 hour = qMax(qint64(0), (itemStates.availableDates[i]-mStartTime)/3600);
+
+                if (hour < NbOfHours) {
+                    items[(accelerated*BurnedLevel+srsLevel)*NbOfHours+int(hour)] += 1.0;
+                }
+            }
+        } else {
+            int lessonHour = pTypeForecast.lessonHours[i];
+
+            if (lessonHour >= 0) {
+                int hour = lessonHour+SrsIntervals[accelerated][0];
+
+                if (hour < NbOfHours) {
+                    items[(accelerated*BurnedLevel+1)*NbOfHours+hour] += 1.0;
+                }
+            }
+        }
+    }
+
+    // Go through our hours and, for each of them, review our items and
+    // propagate them through our SRS intervals, i.e. move them up one SRS
+    // level if they pass their review or down one (two for Guru and above)
+    // SRS level if they don't
+
+    double passProbability = pTypeForecast.passProbability;
+
+    pTypeForecast.reviews = QVector<double>(NbOfHours);
+
+    for (int hour = 0; hour < NbOfHours; ++hour) {
+        double reviews = 0.0;
+
+        for (int accelerated = 0; accelerated < 2; ++accelerated) {
+            const int *srsIntervals = SrsIntervals[accelerated];
+            double *acceleratedItems = items.data()+accelerated*BurnedLevel*NbOfHours;
+
+            for (int srsLevel = 1; srsLevel < BurnedLevel; ++srsLevel) {
+                double nbOfItems = acceleratedItems[srsLevel*NbOfHours+hour];
+
+                if (nbOfItems == 0.0) {
+                    continue;
+                }
+
+                reviews += nbOfItems;
+
+                int passedSrsLevel = srsLevel+1;
+
+                if (passedSrsLevel < BurnedLevel) {
+                    int passedHour = hour+srsIntervals[passedSrsLevel-1];
+
+                    if (passedHour < NbOfHours) {
+                        acceleratedItems[passedSrsLevel*NbOfHours+passedHour] += passProbability*nbOfItems;
+                    }
+                }
+
+                int failedSrsLevel = qMax(1, srsLevel-((srsLevel < GuruLevel)?1:2));
+                int failedHour = hour+srsIntervals[failedSrsLevel-1];
+
+                if (failedHour < NbOfHours) {
+                    acceleratedItems[failedSrsLevel*NbOfHours+failedHour] += (1.0-passProbability)*nbOfItems;
+                }
+            }
+        }
+
+        pTypeForecast.reviews[hour] = reviews;
+    }
+}
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,95 @@
+/*******************************************************************************
+
+Copyright Alan Garny
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Workload forecast
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "wanikani.h"
+
+//==============================================================================
+
+#include <QVector>
+
+//==============================================================================
+
+class WorkloadForecast
+{
+public:
+    enum {
+        NbOfDays = 90,
+        NbOfHours = 24*NbOfDays
+    };
+
+    explicit WorkloadForecast();
+
+    void reset();
+
+    void add(ItemColumns::ItemType pType, int pLevel, int pSrsLevel,
+             uint pUnlockedDate, uint pAvailableDate);
+
+    void forecast(qint64 pNowTime, double pAccuracy, int pNbOfLessonsPerDay);
+
+    qint64 startTime() const;
+    const QVector<double> & reviews() const;
+
+private:
+    struct ItemStates
+    {
+        QVector<int> levels;
+        QVector<int> srsLevels;
+        QVector<qint64> availableDates;
+        QVector<bool> unlocked;
+
+        void clear();
+        void add(int pLevel, int pSrsLevel, uint pUnlockedDate,
+                 uint pAvailableDate);
+    };
+
+    struct Lesson
+    {
+        bool unlocked;
+        int level;
+        int type;
+        int index;
+    };
+
+    struct TypeForecast
+    {
+        const ItemStates *itemStates;
+        double passProbability;
+        QVector<int> lessonHours;
+        QVector<double> reviews;
+    };
+
+    qint64 mStartTime;
+
+    ItemStates mItemStates[ItemColumns::NbOfItemTypes];
+
+    QVector<double> mReviews;
+
+    void forecastReviews(TypeForecast &pTypeForecast) const;
+};
+
+//==============================================================================
+// End of file
+//==============================================================================